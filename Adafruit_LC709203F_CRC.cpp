@@ -0,0 +1,208 @@
+/*!
+ *  @file Adafruit_LC709203F_CRC.cpp
+ *
+ * 	CRC-8 (polynomial 0x07) engines used by the LC709203F I2C protocol
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_CRC.h"
+#include "Adafruit_LC709203F.h"
+
+/*! CRC state after shifting 'i' through 8 steps, i = 0..255 */
+static constexpr uint8_t lc709_crc8_table[256] LC709_CRC_TABLE_ATTR = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31,
+    0x24, 0x23, 0x2A, 0x2D, 0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65,
+    0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D, 0xE0, 0xE7, 0xEE, 0xE9,
+    0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1,
+    0xB4, 0xB3, 0xBA, 0xBD, 0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2,
+    0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA, 0xB7, 0xB0, 0xB9, 0xBE,
+    0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16,
+    0x03, 0x04, 0x0D, 0x0A, 0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42,
+    0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A, 0x89, 0x8E, 0x87, 0x80,
+    0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8,
+    0xDD, 0xDA, 0xD3, 0xD4, 0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C,
+    0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44, 0x19, 0x1E, 0x17, 0x10,
+    0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F,
+    0x6A, 0x6D, 0x64, 0x63, 0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B,
+    0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13, 0xAE, 0xA9, 0xA0, 0xA7,
+    0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF,
+    0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+/*! CRC state after shifting 'i' through 8 steps, i = 0..15 */
+static constexpr uint8_t lc709_crc8_nibble_table[16] LC709_CRC_TABLE_ATTR = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+    0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+};
+
+/*!
+ *    @brief  Check table entries against the constexpr engine (compile time)
+ *    @param table The table, entry i being the CRC state of byte i
+ *    @param i First entry to check
+ *    @return True if entries i..N-1 all match
+ */
+template <size_t N>
+static constexpr bool lc709_crc8_table_ok(const uint8_t (&table)[N],
+                                          size_t i = 0) {
+  return i == N || (table[i] == lc709_crc8_update_ce(0, (uint8_t)i) &&
+                    lc709_crc8_table_ok(table, i + 1));
+}
+
+// Every table entry must match the constexpr engine, which in turn must
+// match a datasheet vector, so a typo in a table cannot build
+static_assert(lc709_crc8_table_ok(lc709_crc8_table),
+              "LC709203F CRC8 table mismatch");
+static_assert(lc709_crc8_table_ok(lc709_crc8_nibble_table),
+              "LC709203F CRC8 nibble table mismatch");
+static constexpr uint8_t lc709_crc8_check[] = {0x16, 0x15, 0x01, 0x00};
+static_assert(lc709_crc8_ce(lc709_crc8_check, 4) == 0x64,
+              "LC709203F CRC8 reference vector mismatch");
+
+/*!
+ *    @brief  Fold one byte into a CRC state, one bit at a time
+ *    @param crc The current CRC state
+ *    @param data The byte to add
+ *    @return The new CRC state
+ */
+uint8_t lc709_crc8_update_bitwise(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (int i = 8; i; --i) {
+    crc = (crc & 0x80) ? (crc << 1) ^ LC709203F_CRC_POLYNOMIAL : (crc << 1);
+  }
+  return crc;
+}
+
+/*!
+ *    @brief  Fold one byte into a CRC state, one nibble at a time
+ *    @param crc The current CRC state
+ *    @param data The byte to add
+ *    @return The new CRC state
+ */
+uint8_t lc709_crc8_update_nibble(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  crc = (crc << 4) ^ LC709_CRC_TABLE_READ(lc709_crc8_nibble_table, crc >> 4);
+  crc = (crc << 4) ^ LC709_CRC_TABLE_READ(lc709_crc8_nibble_table, crc >> 4);
+  return crc;
+}
+
+/*!
+ *    @brief  Fold one byte into a CRC state with a single table lookup
+ *    @param crc The current CRC state
+ *    @param data The byte to add
+ *    @return The new CRC state
+ */
+uint8_t lc709_crc8_update_table(uint8_t crc, uint8_t data) {
+  return LC709_CRC_TABLE_READ(lc709_crc8_table, crc ^ data);
+}
+
+/**
+ * Performs a CRC8 calculation on the supplied values.
+ *
+ * @param data  Pointer to the data to use when calculating the CRC8.
+ * @param len   The number of bytes in 'data'.
+ * @param crc   Starting CRC state, 0 for a fresh calculation.
+ *
+ * @return The computed CRC8 value.
+ */
+uint8_t lc709_crc8(const uint8_t *data, size_t len, uint8_t crc) {
+  while (len--) {
+    crc = lc709_crc8_update(crc, *data++);
+  }
+  return crc;
+}
+
+/*! CRC state after the write prefix for a command at the default address */
+#define LC709_WRITE_PREFIX(cmd)                                                \
+  lc709_crc8_write_prefix_ce(LC709203F_I2CADDR_DEFAULT, cmd)
+/*! CRC state after the read prefix for a command at the default address */
+#define LC709_READ_PREFIX(cmd)                                                 \
+  lc709_crc8_read_prefix_ce(LC709203F_I2CADDR_DEFAULT, cmd)
+
+#define LC709_PREFIX_FIRST LC709203F_CMD_THERMISTORB ///< First tabled command
+#define LC709_PREFIX_LAST LC709203F_CMD_PARAMETER    ///< Last tabled command
+
+// Precomputed CRC states for every command, so a transaction only has to
+// fold in its two data bytes
+static const uint8_t lc709_write_prefix[] LC709_CRC_TABLE_ATTR = {
+    LC709_WRITE_PREFIX(0x06),
+    LC709_WRITE_PREFIX(0x07),
+    LC709_WRITE_PREFIX(0x08),
+    LC709_WRITE_PREFIX(0x09),
+    LC709_WRITE_PREFIX(0x0A),
+    LC709_WRITE_PREFIX(0x0B),
+    LC709_WRITE_PREFIX(0x0C),
+    LC709_WRITE_PREFIX(0x0D),
+    LC709_WRITE_PREFIX(0x0E),
+    LC709_WRITE_PREFIX(0x0F),
+    LC709_WRITE_PREFIX(0x10),
+    LC709_WRITE_PREFIX(0x11),
+    LC709_WRITE_PREFIX(0x12),
+    LC709_WRITE_PREFIX(0x13),
+    LC709_WRITE_PREFIX(0x14),
+    LC709_WRITE_PREFIX(0x15),
+    LC709_WRITE_PREFIX(0x16),
+    LC709_WRITE_PREFIX(0x17),
+    LC709_WRITE_PREFIX(0x18),
+    LC709_WRITE_PREFIX(0x19),
+    LC709_WRITE_PREFIX(0x1A),
+};
+static const uint8_t lc709_read_prefix[] LC709_CRC_TABLE_ATTR = {
+    LC709_READ_PREFIX(0x06),
+    LC709_READ_PREFIX(0x07),
+    LC709_READ_PREFIX(0x08),
+    LC709_READ_PREFIX(0x09),
+    LC709_READ_PREFIX(0x0A),
+    LC709_READ_PREFIX(0x0B),
+    LC709_READ_PREFIX(0x0C),
+    LC709_READ_PREFIX(0x0D),
+    LC709_READ_PREFIX(0x0E),
+    LC709_READ_PREFIX(0x0F),
+    LC709_READ_PREFIX(0x10),
+    LC709_READ_PREFIX(0x11),
+    LC709_READ_PREFIX(0x12),
+    LC709_READ_PREFIX(0x13),
+    LC709_READ_PREFIX(0x14),
+    LC709_READ_PREFIX(0x15),
+    LC709_READ_PREFIX(0x16),
+    LC709_READ_PREFIX(0x17),
+    LC709_READ_PREFIX(0x18),
+    LC709_READ_PREFIX(0x19),
+    LC709_READ_PREFIX(0x1A),
+};
+
+/*!
+ *    @brief  CRC state after the fixed write prefix (address, command),
+ *            from a table for the default address
+ *    @param addr The 7-bit I2C address
+ *    @param command The I2C register/command
+ *    @return The CRC state to fold the data bytes into
+ */
+uint8_t lc709_crc8_write_prefix(uint8_t addr, uint8_t command) {
+  if (addr == LC709203F_I2CADDR_DEFAULT && command >= LC709_PREFIX_FIRST &&
+      command <= LC709_PREFIX_LAST)
+    return LC709_CRC_TABLE_READ(lc709_write_prefix,
+                                command - LC709_PREFIX_FIRST);
+  return lc709_crc8_update(lc709_crc8_update(0, addr << 1), command);
+}
+
+/*!
+ *    @brief  CRC state after the fixed read prefix (address, command, read
+ *            address), from a table for the default address
+ *    @param addr The 7-bit I2C address
+ *    @param command The I2C register/command
+ *    @return The CRC state to fold the reply bytes into
+ */
+uint8_t lc709_crc8_read_prefix(uint8_t addr, uint8_t command) {
+  if (addr == LC709203F_I2CADDR_DEFAULT && command >= LC709_PREFIX_FIRST &&
+      command <= LC709_PREFIX_LAST)
+    return LC709_CRC_TABLE_READ(lc709_read_prefix,
+                                command - LC709_PREFIX_FIRST);
+  return lc709_crc8_update(lc709_crc8_write_prefix(addr, command),
+                           (addr << 1) | 1);
+}
@@ -0,0 +1,127 @@
+/*!
+ *  @file Adafruit_LC709203F_CRC.h
+ *
+ * 	CRC-8 (polynomial 0x07) engines used by the LC709203F I2C protocol
+ *
+ * 	Three interchangeable runtime engines are provided, selected at build time
+ * 	with LC709203F_CRC_ENGINE:
+ * 	  - LC709203F_CRC_BITWISE: bit-serial, no table
+ * 	  - LC709203F_CRC_NIBBLE: 16 byte table, two lookups per byte
+ * 	  - LC709203F_CRC_TABLE: 256 byte table in flash, one lookup per byte
+ *
+ * 	A constexpr engine is also available for values known at compile time.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_CRC_H
+#define _ADAFRUIT_LC709203F_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define LC709_CRC_TABLE_ATTR PROGMEM                      ///< Tables in flash
+#define LC709_CRC_TABLE_READ(t, i) pgm_read_byte(&(t)[i]) ///< Table access
+#else
+#define LC709_CRC_TABLE_ATTR                ///< Const data is already in flash
+#define LC709_CRC_TABLE_READ(t, i) ((t)[i]) ///< Table access
+#endif
+
+#define LC709203F_CRC_POLYNOMIAL 0x07 ///< CRC-8 polynomial x^8 + x^2 + x + 1
+
+#define LC709203F_CRC_BITWISE 0 ///< Bit-serial CRC engine
+#define LC709203F_CRC_NIBBLE 1  ///< 16-entry table CRC engine
+#define LC709203F_CRC_TABLE 2   ///< 256-entry table CRC engine
+
+#ifndef LC709203F_CRC_ENGINE
+#define LC709203F_CRC_ENGINE LC709203F_CRC_TABLE ///< Runtime CRC engine
+#endif
+
+uint8_t lc709_crc8_update_bitwise(uint8_t crc, uint8_t data);
+uint8_t lc709_crc8_update_nibble(uint8_t crc, uint8_t data);
+uint8_t lc709_crc8_update_table(uint8_t crc, uint8_t data);
+
+/*!
+ *    @brief  Shift a CRC state through a number of bit steps (compile time)
+ *    @param crc The current CRC state
+ *    @param bits Number of bit steps left
+ *    @return The new CRC state
+ */
+constexpr uint8_t lc709_crc8_shift_ce(uint8_t crc, int bits) {
+  return bits ? lc709_crc8_shift_ce(
+                    (crc & 0x80) ? (uint8_t)((crc << 1) ^
+                                             LC709203F_CRC_POLYNOMIAL)
+                                 : (uint8_t)(crc << 1),
+                    bits - 1)
+              : crc;
+}
+
+/*!
+ *    @brief  Fold one byte into a CRC state (compile time)
+ *    @param crc The current CRC state
+ *    @param data The byte to add
+ *    @return The new CRC state
+ */
+constexpr uint8_t lc709_crc8_update_ce(uint8_t crc, uint8_t data) {
+  return lc709_crc8_shift_ce(crc ^ data, 8);
+}
+
+/*!
+ *    @brief  CRC8 of a buffer (compile time)
+ *    @param data Pointer to the bytes to check
+ *    @param len The number of bytes in 'data'
+ *    @param crc Starting CRC state, 0 for a fresh calculation
+ *    @return The computed CRC8 value
+ */
+constexpr uint8_t lc709_crc8_ce(const uint8_t *data, size_t len,
+                                uint8_t crc = 0) {
+  return len ? lc709_crc8_ce(data + 1, len - 1,
+                             lc709_crc8_update_ce(crc, *data))
+             : crc;
+}
+
+/*!
+ *    @brief  Fold one byte into a CRC state using the selected engine
+ *    @param crc The current CRC state
+ *    @param data The byte to add
+ *    @return The new CRC state
+ */
+static inline uint8_t lc709_crc8_update(uint8_t crc, uint8_t data) {
+#if LC709203F_CRC_ENGINE == LC709203F_CRC_TABLE
+  return lc709_crc8_update_table(crc, data);
+#elif LC709203F_CRC_ENGINE == LC709203F_CRC_NIBBLE
+  return lc709_crc8_update_nibble(crc, data);
+#else
+  return lc709_crc8_update_bitwise(crc, data);
+#endif
+}
+
+uint8_t lc709_crc8(const uint8_t *data, size_t len, uint8_t crc = 0);
+uint8_t lc709_crc8_write_prefix(uint8_t addr, uint8_t command);
+uint8_t lc709_crc8_read_prefix(uint8_t addr, uint8_t command);
+
+/*!
+ *    @brief  CRC state after the fixed write prefix (address, command)
+ *    @param addr The 7-bit I2C address
+ *    @param command The register/command byte
+ *    @return The CRC state to fold the data bytes into
+ */
+constexpr uint8_t lc709_crc8_write_prefix_ce(uint8_t addr, uint8_t command) {
+  return lc709_crc8_update_ce(lc709_crc8_update_ce(0, addr << 1), command);
+}
+
+/*!
+ *    @brief  CRC state after the fixed read prefix (address, command,
+ *            read address)
+ *    @param addr The 7-bit I2C address
+ *    @param command The register/command byte
+ *    @return The CRC state to fold the reply bytes into
+ */
+constexpr uint8_t lc709_crc8_read_prefix_ce(uint8_t addr, uint8_t command) {
+  return lc709_crc8_update_ce(lc709_crc8_write_prefix_ce(addr, command),
+                              (addr << 1) | 1);
+}
+
+#endif
@@ -0,0 +1,213 @@
+/*!
+ *  @file Adafruit_LC709203F_Core.h
+ *
+ * 	Header-only LC709203F word protocol, templated on bus type and address
+ *
+ * 	Adafruit_LC709203F_Core<Bus, Address> does the CRC-framed register
+ * 	reads and writes with the bus type and I2C address fixed at compile
+ * 	time. readWord(), writeWord() and the readRegister<>() /
+ * 	writeRegister<>() forms need only BusIO-style write() and
+ * 	write_then_read() methods, so Bus can be Adafruit_I2CDevice itself and
+ * 	a board that only ever uses one bus gets direct, non-virtual calls.
+ * 	readRegister<>() / writeRegister<>() also resolve the CRC prefix of the
+ * 	command at compile time; readWord() / writeWord() look it up in a
+ * 	table. readWords() additionally needs write_then_read_batch(), i.e. an
+ * 	Adafruit_LC709203F_Transport.
+ *
+ * 	This is raw register access only; Adafruit_LC709203F_Driver builds the
+ * 	getters, configuration, cache, retries, snapshots and alarms on it,
+ * 	with the same Bus and Address, passing the prefixes it folds at
+ * 	compile time to readWordPrefixed() and writeWordPrefixed().
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_CORE_H
+#define _ADAFRUIT_LC709203F_CORE_H
+
+#include "Adafruit_LC709203F_CRC.h"
+#include "Adafruit_LC709203F_Transport.h"
+
+/*!
+ *    @brief  LC709203F register access over a compile-time bus and address
+ */
+template <class Bus, uint8_t Address> class Adafruit_LC709203F_Core {
+public:
+  /*!
+   *    @brief  Bind to a bus
+   *    @param bus The bus the LC709203F is attached to
+   */
+  explicit Adafruit_LC709203F_Core(Bus *bus = NULL) : _bus(bus) {}
+
+  /*!
+   *    @brief  Change the bus
+   *    @param bus The bus the LC709203F is attached to
+   */
+  void setBus(Bus *bus) { _bus = bus; }
+
+  /*!
+   *    @brief  The bus in use
+   *    @return Pointer to the bus
+   */
+  Bus *getBus(void) const { return _bus; }
+
+  /*!
+   *    @brief  Check the CRC on a 3 byte read reply and unpack the word
+   *    @param crc CRC state after the read prefix of the command
+   *    @param reply Low byte, high byte and CRC as read from the chip
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return True if the CRC matched
+   */
+  static bool decodeReply(uint8_t crc, const uint8_t *reply, uint16_t *data) {
+    // CRC failure?
+    if (lc709_crc8(reply, 2, crc) != reply[2])
+      return false;
+
+    *data = reply[1];
+    *data <<= 8;
+    *data |= reply[0];
+    return true;
+  }
+
+  /*!
+   *    @brief  CRC state after the read prefix of a command
+   *    @param command The I2C register/command
+   *    @return The CRC state to fold the reply bytes into
+   */
+  static uint8_t readPrefix(uint8_t command) {
+    return lc709_crc8_read_prefix(Address, command);
+  }
+
+  /*!
+   *    @brief  CRC state after the write prefix of a command
+   *    @param command The I2C register/command
+   *    @return The CRC state to fold the data bytes into
+   */
+  static uint8_t writePrefix(uint8_t command) {
+    return lc709_crc8_write_prefix(Address, command);
+  }
+
+  /*!
+   *    @brief  Read a register
+   *    @param command The I2C register/command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @param acked If not NULL, set to whether the transfer completed, to
+   *           tell a NACK from a CRC failure
+   *    @return True on successful I2C read with a matching CRC
+   */
+  bool readWord(uint8_t command, uint16_t *data, bool *acked = NULL) {
+    return readWordPrefixed(command, readPrefix(command), data, acked);
+  }
+
+  /*!
+   *    @brief  Read a register whose CRC prefix the caller already has
+   *    @param command The I2C register/command
+   *    @param prefix readPrefix() of the command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @param acked If not NULL, set to whether the transfer completed, to
+   *           tell a NACK from a CRC failure
+   *    @return True on successful I2C read with a matching CRC
+   */
+  bool readWordPrefixed(uint8_t command, uint8_t prefix, uint16_t *data,
+                        bool *acked = NULL) {
+    uint8_t reply[3];
+    bool ok = _bus->write_then_read(&command, 1, reply, 3);
+    if (acked)
+      *acked = ok;
+    return ok && decodeReply(prefix, reply, data);
+  }
+
+  /*!
+   *    @brief  Read several registers in one batch, which the bus may issue
+   *            as a single transaction. Bus must have write_then_read_batch()
+   *    @param commands The I2C registers/commands, at most 8
+   *    @param data Where to store each value, in the same order
+   *    @param count Number of registers
+   *    @param acked If not NULL, set to a mask of the transfers that
+   *           completed, CRC aside
+   *    @param prefixes readPrefix() of each command, NULL to look them up
+   *    @return Bit i set if register i was read with a matching CRC
+   */
+  uint8_t readWords(const uint8_t *commands, uint16_t *const *data,
+                    uint8_t count, uint8_t *acked = NULL,
+                    const uint8_t *prefixes = NULL) {
+    lc709203_xfer_t xfers[8];
+    uint8_t reply[8][3];
+    if (count > 8)
+      count = 8;
+    for (uint8_t i = 0; i < count; i++) {
+      xfers[i].write_buffer = &commands[i];
+      xfers[i].write_len = 1;
+      xfers[i].read_buffer = reply[i];
+      xfers[i].read_len = 3;
+      xfers[i].ok = false;
+    }
+    _bus->write_then_read_batch(xfers, count);
+
+    uint8_t good = 0, done = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!xfers[i].ok)
+        continue;
+      done |= 1 << i;
+      uint8_t prefix = prefixes ? prefixes[i] : readPrefix(commands[i]);
+      if (decodeReply(prefix, reply[i], data[i]))
+        good |= 1 << i;
+    }
+    if (acked)
+      *acked = done;
+    return good;
+  }
+
+  /*!
+   *    @brief  Write a register
+   *    @param command The I2C register/command
+   *    @param data The value to write
+   *    @return True on successful I2C write
+   */
+  bool writeWord(uint8_t command, uint16_t data) {
+    return writeWordPrefixed(command, writePrefix(command), data);
+  }
+
+  /*!
+   *    @brief  Write a register whose CRC prefix the caller already has
+   *    @param command The I2C register/command
+   *    @param prefix writePrefix() of the command
+   *    @param data The value to write
+   *    @return True on successful I2C write
+   */
+  bool writeWordPrefixed(uint8_t command, uint8_t prefix, uint16_t data) {
+    uint8_t send[4];
+    send[0] = command; // command / register
+    send[1] = data & 0xFF;
+    send[2] = data >> 8;
+    send[3] = lc709_crc8(send + 1, 2, prefix);
+    return _bus->write(send, 4);
+  }
+
+  /*!
+   *    @brief  Read a register known at compile time
+   *    @tparam Command The I2C register/command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return True on successful I2C read with a matching CRC
+   */
+  template <uint8_t Command> bool readRegister(uint16_t *data) {
+    constexpr uint8_t prefix = lc709_crc8_read_prefix_ce(Address, Command);
+    return readWordPrefixed(Command, prefix, data);
+  }
+
+  /*!
+   *    @brief  Write a register known at compile time
+   *    @tparam Command The I2C register/command
+   *    @param data The value to write
+   *    @return True on successful I2C write
+   */
+  template <uint8_t Command> bool writeRegister(uint16_t data) {
+    constexpr uint8_t prefix = lc709_crc8_write_prefix_ce(Address, Command);
+    return writeWordPrefixed(Command, prefix, data);
+  }
+
+private:
+  Bus *_bus;
+};
+
+#endif
@@ -0,0 +1,1396 @@
+/*!
+ *  @file Adafruit_LC709203F_Driver.h
+ *
+ * 	Header-only LC709203F driver, templated on bus type and address
+ *
+ * 	Adafruit_LC709203F_Driver<Bus, Address> is the whole driver: getters,
+ * 	configuration, cache, retries, snapshots and alarms. Registers named
+ * 	at compile time go to the bus with their CRC prefix already folded,
+ * 	and when Bus is a final class every bus call is a direct call.
+ * 	Adafruit_LC709203F is the instantiation over the built-in BusIO
+ * 	transport on Arduino; Adafruit_LC709203F_Generic takes any
+ * 	Adafruit_LC709203F_Transport at run time, such as a mux channel or the
+ * 	Linux i2c-dev transport. A board with its own bus class can
+ * 	instantiate the template over it directly.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_DRIVER_H
+#define _ADAFRUIT_LC709203F_DRIVER_H
+
+// LC709203F_NO_FLOAT drops the floating point API, keeping only the
+// integer getters, for MCUs without an FPU. It must be a global build flag
+// (PlatformIO build_flags, or arduino-cli --build-property
+// "compiler.cpp.extra_flags=-DLC709203F_NO_FLOAT") so the library's own
+// .cpp files see it too. A #define in a sketch only hides the
+// declarations; the float code then only goes away if the linker drops it
+// as unused, as it does with the section GC most Arduino cores use
+
+#include "Adafruit_LC709203F_Core.h"
+#include "Adafruit_LC709203F_Transport.h"
+#include <string.h>
+
+#define LC709203F_I2CADDR_DEFAULT 0x0B     ///< LC709203F default i2c address
+#define LC709203F_CMD_THERMISTORB 0x06     ///< Read/write thermistor B
+#define LC709203F_CMD_INITRSOC 0x07        ///< Initialize RSOC calculation
+#define LC709203F_CMD_CELLTEMPERATURE 0x08 ///< Read/write batt temperature
+#define LC709203F_CMD_CELLVOLTAGE 0x09     ///< Read batt voltage
+#define LC709203F_CMD_APA 0x0B             ///< Adjustment Pack Application
+#define LC709203F_CMD_RSOC 0x0D            ///< Read state of charge
+#define LC709203F_CMD_CELLITE 0x0F         ///< Read batt indicator to empty
+#define LC709203F_CMD_ICVERSION 0x11       ///< Read IC version
+#define LC709203F_CMD_BATTPROF 0x12        ///< Set the battery profile
+#define LC709203F_CMD_ALARMRSOC 0x13       ///< Alarm on percent threshold
+#define LC709203F_CMD_ALARMVOLT 0x14       ///< Alarm on voltage threshold
+#define LC709203F_CMD_POWERMODE 0x15       ///< Sets sleep/power mode
+#define LC709203F_CMD_STATUSBIT 0x16       ///< Temperature obtaining method
+#define LC709203F_CMD_PARAMETER 0x1A       ///< Batt profile code
+
+/*!  Battery temperature source */
+typedef enum {
+  LC709203F_TEMPERATURE_I2C = 0x0000,
+  LC709203F_TEMPERATURE_THERMISTOR = 0x0001,
+} lc709203_tempmode_t;
+
+/*!  Chip power state */
+typedef enum {
+  LC709203F_POWER_OPERATE = 0x0001,
+  LC709203F_POWER_SLEEP = 0x0002,
+} lc709203_powermode_t;
+
+/*!  Approx battery pack size */
+typedef enum {
+  LC709203F_APA_100MAH = 0x08,
+  LC709203F_APA_200MAH = 0x0B,
+  LC709203F_APA_500MAH = 0x10,
+  LC709203F_APA_1000MAH = 0x19,
+  LC709203F_APA_2000MAH = 0x2D,
+  LC709203F_APA_3000MAH = 0x36,
+} lc709203_adjustment_t;
+
+#define LC709203F_TEMP_ZERO_C 0x0AAC ///< Temperature register value at 0 *C
+#define LC709203F_TEMP_MIN 0x09E4    ///< Lowest temperature register (-20 *C)
+#define LC709203F_TEMP_MAX 0x0D04    ///< Highest temperature register (60 *C)
+
+/*!
+ *    @brief  Convert the temperature register (0.1 K) to 0.1 *C. The chip
+ *            defines 0 *C as exactly 0x0AAC, so this is lossless
+ *    @param deci_kelvin Register value
+ *    @return Temperature in 0.1 *C
+ */
+static inline int16_t lc709_temp_to_deci_celsius(uint16_t deci_kelvin) {
+  return (int16_t)(deci_kelvin - LC709203F_TEMP_ZERO_C);
+}
+
+/*!
+ *    @brief  Convert 0.1 *C to the temperature register format (0.1 K)
+ *    @param deci_celsius Temperature in 0.1 *C
+ *    @return Register value
+ */
+static inline uint16_t lc709_deci_celsius_to_temp(int16_t deci_celsius) {
+  return (uint16_t)(deci_celsius + LC709203F_TEMP_ZERO_C);
+}
+
+#define LC709203F_SHADOW_REGS 9 ///< Number of shadowed configuration registers
+
+#define LC709203F_SNAPSHOT_VOLTAGE 0x01     ///< snapshot voltage is valid
+#define LC709203F_SNAPSHOT_ITE 0x02         ///< snapshot ITE is valid
+#define LC709203F_SNAPSHOT_RSOC 0x04        ///< snapshot RSOC is valid
+#define LC709203F_SNAPSHOT_TEMPERATURE 0x08 ///< snapshot temp is valid
+#define LC709203F_SNAPSHOT_ALL 0x0F         ///< every snapshot field valid
+
+/*!  Why a register access failed */
+typedef enum {
+  LC709203F_OK,          ///< No error
+  LC709203F_ERR_NACK,    ///< The chip did not acknowledge, or bus error
+  LC709203F_ERR_CRC,     ///< The reply arrived with a bad CRC
+  LC709203F_ERR_TIMEOUT, ///< The bus timed out
+  LC709203F_ERR_RANGE,   ///< Read fine, but outside the chip's valid range
+} lc709203_error_t;
+
+/*!  A register value with its lc709203_error_t, 4 bytes so it is returned
+ *   in registers on most ABIs */
+typedef struct {
+  uint16_t value; ///< The value read, 0 unless error is LC709203F_OK
+  uint8_t error;  ///< lc709203_error_t of the read
+} lc709203_result_t;
+
+#define LC709203F_VOLTAGE_MIN 2000 ///< Lowest plausible cell voltage, mV
+#define LC709203F_VOLTAGE_MAX 5000 ///< Highest plausible cell voltage, mV
+
+/*!  Raw live measurements, as read by readSnapshot() */
+typedef struct {
+  uint16_t voltage;     ///< Cell voltage in mV
+  uint16_t ite;         ///< Indicator to empty in 0.1% units
+  uint16_t rsoc;        ///< Relative state of charge in %
+  uint16_t temperature; ///< Cell temperature in 0.1 K units
+  uint8_t valid;        ///< LC709203F_SNAPSHOT_* bits of the fields read OK
+} lc709203_snapshot_t;
+
+#define LC709203F_CONFIG_POWERMODE 0x01   ///< apply power_mode
+#define LC709203F_CONFIG_APA 0x02         ///< apply apa
+#define LC709203F_CONFIG_BATTPROF 0x04    ///< apply batt_profile
+#define LC709203F_CONFIG_TEMPMODE 0x08    ///< apply temp_mode
+#define LC709203F_CONFIG_THERMISTORB 0x10 ///< apply thermistor_b
+#define LC709203F_CONFIG_ALARMRSOC 0x20   ///< apply alarm_rsoc
+#define LC709203F_CONFIG_ALARMVOLT 0x40   ///< apply alarm_voltage
+
+/*!  Chip configuration staged for applyConfig() */
+typedef struct {
+  uint8_t fields;                   ///< LC709203F_CONFIG_* bits to apply
+  lc709203_powermode_t power_mode;  ///< Power mode
+  uint8_t apa;                      ///< APA value, see lc709203_adjustment_t
+  uint16_t batt_profile;            ///< Battery profile (0 or 1)
+  lc709203_tempmode_t temp_mode;    ///< Temperature source
+  uint16_t thermistor_b;            ///< Thermistor B value
+  uint8_t alarm_rsoc;               ///< RSOC alarm threshold in %, 0 = off
+  uint16_t alarm_voltage;           ///< Voltage alarm threshold in mV, 0 = off
+} lc709203_config_t;
+
+/*!  A snapshot with the time it was taken */
+typedef struct {
+  uint32_t timestamp;       ///< Transport clock when read, in ms
+  lc709203_snapshot_t data; ///< Measurements and their validity bits
+} lc709203_sample_t;
+
+/*!
+ *    @brief  Receives every sample read by readSnapshot(). Sinks form a
+ *            list, see Adafruit_LC709203F_Driver::addSampleSink()
+ */
+class Adafruit_LC709203F_SampleSink {
+public:
+  virtual ~Adafruit_LC709203F_SampleSink() {}
+  /*!
+   *    @brief  Take one sample
+   *    @param sample The sample just read
+   */
+  virtual void addSample(const lc709203_sample_t &sample) = 0;
+
+  Adafruit_LC709203F_SampleSink *next_sink = NULL; ///< Next sink in the list
+};
+
+#define LC709203F_ALARM_RSOC 0x01    ///< RSOC fell to the RSOC threshold
+#define LC709203F_ALARM_VOLTAGE 0x02 ///< Voltage fell below the threshold
+
+/*! Called from serviceAlarm() with the LC709203F_ALARM_* bits that fired */
+typedef void (*lc709203_alarm_callback_t)(uint8_t alarms);
+
+#define LC709203F_RETRY_NACK 0x01 ///< Retry transfers the chip did not ACK
+#define LC709203F_RETRY_CRC 0x02  ///< Retry reads that arrived corrupted
+
+/*!  How register reads and writes are retried, see setRetryPolicy() */
+typedef struct {
+  uint8_t attempts;        ///< Tries per access, 1 for no retries
+  uint8_t retry_on;        ///< LC709203F_RETRY_* failures worth retrying
+  uint16_t backoff_us;     ///< Wait before the first retry, doubled after
+  uint16_t max_backoff_us; ///< Longest wait between tries, 0 for no limit
+  uint32_t budget_us;      ///< Time an access may take, 0 for no limit
+} lc709203_retry_t;
+
+#define LC709203F_READ_TIMEOUT_US 35000UL ///< Default startRead() deadline
+
+// LC709203F_INSTRUMENT compiles in the hooks that count bus errors and
+// time every transfer into a latency histogram per register, kept in
+// storage attached with setInstrumentation(). Without it the hooks are
+// compiled out and setInstrumentation() refuses storage. The class layout
+// does not depend on it, but like LC709203F_NO_FLOAT it must be a global
+// build flag for the library's own .cpp files to see it
+#define LC709203F_LATENCY_BUCKETS 16 ///< Histogram buckets per register
+#define LC709203F_STAT_REGS 14       ///< Registers with a histogram
+
+/*!  Bus health counters, see Adafruit_LC709203F_Driver::counters() */
+typedef struct {
+  uint32_t transactions; ///< Register reads and writes sent to the bus
+  uint32_t nacks;        ///< Transfers the bus reported as failed
+  uint32_t crc_errors;   ///< Reads that arrived with a bad CRC
+  uint32_t retries;      ///< Retries taken by the retry policy
+} lc709203_counters_t;
+
+/*!  Instrumentation storage, see setInstrumentation() */
+typedef struct {
+  lc709203_counters_t counters; ///< Bus health counters
+  /*! Transfer latency histograms, see latencyBucketFloor() */
+  uint16_t latency[LC709203F_STAT_REGS][LC709203F_LATENCY_BUCKETS];
+} lc709203_instrument_t;
+
+// Code run from an interrupt must sit in RAM on the ESP8266 and ESP32,
+// whose cores define IRAM_ATTR; elsewhere it is nothing
+#ifdef IRAM_ATTR
+#define LC709203F_ISR_ATTR IRAM_ATTR ///< Placement of interrupt code
+#else
+#define LC709203F_ISR_ATTR ///< Placement of interrupt code
+#endif
+
+// Out of line, as the compiler ignores section attributes on template
+// members; see Adafruit_LC709203F_Driver::alarmEdge()
+void lc709_alarm_edge(volatile bool *pending);
+
+#if defined(ARDUINO)
+/*! alarm_pending of the driver owning the ALARMB interrupt, NULL if none */
+extern volatile bool *lc709_alarm_flag;
+void lc709_alarm_isr(void);
+#endif
+
+/*!
+ *    @brief  Find the shadow slot of a configuration register
+ *    @param command The I2C register/command
+ *    @return Slot index, or -1 for live registers that are never shadowed
+ */
+static inline int8_t lc709_shadow_slot(uint8_t command) {
+  switch (command) {
+  case LC709203F_CMD_THERMISTORB:
+    return 0;
+  case LC709203F_CMD_APA:
+    return 1;
+  case LC709203F_CMD_ICVERSION:
+    return 2;
+  case LC709203F_CMD_BATTPROF:
+    return 3;
+  case LC709203F_CMD_ALARMRSOC:
+    return 4;
+  case LC709203F_CMD_ALARMVOLT:
+    return 5;
+  case LC709203F_CMD_POWERMODE:
+    return 6;
+  case LC709203F_CMD_STATUSBIT:
+    return 7;
+  case LC709203F_CMD_PARAMETER:
+    return 8;
+  default:
+    return -1;
+  }
+}
+
+/*!
+ *    @brief  Register and value for each LC709203F_CONFIG_* field, in the
+ *            order they get written
+ *    @param config The configuration to read values from
+ *    @param cmds Filled in with 7 commands
+ *    @param vals Filled in with 7 values
+ */
+static inline void lc709_config_words(const lc709203_config_t *config,
+                                      uint8_t *cmds, uint16_t *vals) {
+  cmds[0] = LC709203F_CMD_POWERMODE;
+  vals[0] = config->power_mode;
+  cmds[1] = LC709203F_CMD_APA;
+  vals[1] = config->apa;
+  cmds[2] = LC709203F_CMD_BATTPROF;
+  vals[2] = config->batt_profile;
+  cmds[3] = LC709203F_CMD_STATUSBIT;
+  vals[3] = config->temp_mode;
+  cmds[4] = LC709203F_CMD_THERMISTORB;
+  vals[4] = config->thermistor_b;
+  cmds[5] = LC709203F_CMD_ALARMRSOC;
+  vals[5] = config->alarm_rsoc;
+  cmds[6] = LC709203F_CMD_ALARMVOLT;
+  vals[6] = config->alarm_voltage;
+}
+
+/*!
+ *    @brief  Find the histogram of a register
+ *    @param command The I2C register/command
+ *    @return Histogram index, or -1 for unknown registers
+ */
+static inline int8_t lc709_stat_slot(uint8_t command) {
+  int8_t slot = lc709_shadow_slot(command);
+  if (slot >= 0)
+    return slot;
+  switch (command) {
+  case LC709203F_CMD_INITRSOC:
+    return LC709203F_SHADOW_REGS;
+  case LC709203F_CMD_CELLTEMPERATURE:
+    return LC709203F_SHADOW_REGS + 1;
+  case LC709203F_CMD_CELLVOLTAGE:
+    return LC709203F_SHADOW_REGS + 2;
+  case LC709203F_CMD_RSOC:
+    return LC709203F_SHADOW_REGS + 3;
+  case LC709203F_CMD_CELLITE:
+    return LC709203F_SHADOW_REGS + 4;
+  }
+  return -1;
+}
+
+/*!
+ *    @brief  Log-linear histogram bucket of a latency: two buckets per
+ *            doubling from 32 us, so bucket 1 is 32-47 us, 2 is 48-63 us,
+ *            3 is 64-95 us, and so on up to 4 ms and over in bucket 15
+ *    @param us The latency
+ *    @return Bucket index
+ */
+static inline uint8_t lc709_latency_bucket(uint32_t us) {
+  if (us < 32)
+    return 0;
+  uint8_t msb = 5;
+  while (msb < 31 && (us >> (msb + 1)))
+    msb++;
+  uint8_t bucket = 2 * (msb - 5) + ((us >> (msb - 1)) & 1) + 1;
+  return bucket < LC709203F_LATENCY_BUCKETS ? bucket
+                                            : LC709203F_LATENCY_BUCKETS - 1;
+}
+
+/*!
+ *    @brief  Class that stores state and functions for interacting with
+ *            the LC709203F I2C battery monitor, over a bus type and I2C
+ *            address fixed at compile time. Bus is
+ *            Adafruit_LC709203F_Transport or a class derived from it; if
+ *            that class is final, as Adafruit_LC709203F_BusIO is, calls to
+ *            it need no vtable
+ */
+template <class Bus, uint8_t Address = LC709203F_I2CADDR_DEFAULT>
+class Adafruit_LC709203F_Driver {
+public:
+  /*!
+   *    @brief  Instantiates a new LC709203F driver
+   */
+  Adafruit_LC709203F_Driver(void) {}
+
+  ~Adafruit_LC709203F_Driver(void) {
+#if defined(ARDUINO)
+    detachAlarm(); // the ALARMB interrupt must not outlive us
+#endif
+  }
+
+  /*!
+   *    @brief  Sets up the chip over an already constructed bus transport
+   *    @param  transport
+   *            The transport to talk to the LC709203F through
+   *    @param  config
+   *            Configuration to write, NULL for defaultConfig()
+   *    @return True if initialization was successful, otherwise false.
+   */
+  bool begin(Bus *transport, const lc709203_config_t *config = NULL) {
+    bus_dev = transport;
+    core.setBus(transport);
+    invalidateCache(); // could be a different or power cycled chip
+
+    if (!bus_dev->begin()) {
+      return false;
+    }
+
+    /*
+    uint16_t param ;
+    readWord(LC709203F_CMD_PARAMETER, &param);
+    Serial.print("Profile Param: ");
+    Serial.println(param, HEX);
+    */
+
+    lc709203_config_t defaults;
+    if (!config) {
+      defaultConfig(&defaults);
+      config = &defaults;
+    }
+    return applyConfig(config);
+  }
+
+  /*!
+   *    @brief  Initialize the RSOC algorithm
+   *    @return True on I2C command success
+   */
+  bool initRSOC(void) {
+    return writeRegister<LC709203F_CMD_INITRSOC>(0xAA55);
+  }
+
+  /*!
+   *    @brief  Fill in the configuration begin() uses by default: operating
+   *            power mode, 500mAh APA, 4.2V battery profile and thermistor
+   *            temperature. Adjust the result and pass it to begin() to
+   *            have each register written once
+   *    @param config The configuration to fill in
+   */
+  static void defaultConfig(lc709203_config_t *config) {
+    memset(config, 0, sizeof(*config));
+    config->fields = LC709203F_CONFIG_POWERMODE | LC709203F_CONFIG_APA |
+                     LC709203F_CONFIG_BATTPROF | LC709203F_CONFIG_TEMPMODE;
+    config->power_mode = LC709203F_POWER_OPERATE;
+    config->apa = LC709203F_APA_500MAH;
+    config->batt_profile = 0x1; // use 4.2V profile
+    config->temp_mode = LC709203F_TEMPERATURE_THERMISTOR;
+  }
+
+  /*!
+   *    @brief  Compare a staged configuration with the chip state the
+   *            driver knows about. Registers that were never read or
+   *            written count as different
+   *    @param config The staged configuration
+   *    @return LC709203F_CONFIG_* bits of the fields applyConfig() would
+   *            write
+   */
+  uint8_t diffConfig(const lc709203_config_t *config) {
+    uint8_t cmds[7];
+    uint16_t vals[7];
+    uint8_t dirty = 0;
+
+    lc709_config_words(config, cmds, vals);
+    for (uint8_t i = 0; i < 7; i++) {
+      if (!(config->fields & (1 << i)))
+        continue;
+      int8_t slot = lc709_shadow_slot(cmds[i]);
+      if (!(shadow_valid & (1 << slot)) || shadow[slot] != vals[i])
+        dirty |= 1 << i;
+    }
+    return dirty;
+  }
+
+  /*!
+   *    @brief  Write only the configuration fields that differ from the
+   *            known chip state
+   *    @param config The staged configuration
+   *    @return True if every changed register was written
+   */
+  bool applyConfig(const lc709203_config_t *config) {
+    uint8_t cmds[7];
+    uint16_t vals[7];
+    uint8_t dirty = diffConfig(config);
+
+    lc709_config_words(config, cmds, vals);
+    for (uint8_t i = 0; i < 7; i++) {
+      if ((dirty & (1 << i)) && !writeWord(cmds[i], vals[i]))
+        return false;
+    }
+    return true;
+  }
+
+  /*!
+   *    @brief  Set the power mode, LC709203F_POWER_OPERATE or
+   *            LC709203F_POWER_SLEEP
+   *    @param t The power mode desired
+   *    @return True on successful I2C write
+   */
+  bool setPowerMode(lc709203_powermode_t t) {
+    return writeRegister<LC709203F_CMD_POWERMODE>((uint16_t)t);
+  }
+
+  /*!
+   *    @brief  Set the approximate pack size, helps RSOC calculation
+   *    @param apa The lc709203_adjustment_t enumerated approximate cell size
+   *    @return True on successful I2C write
+   */
+  bool setPackSize(lc709203_adjustment_t apa) {
+    return writeRegister<LC709203F_CMD_APA>((uint16_t)apa);
+  }
+
+  /*!
+   *    @brief  Set battery APA value, per LC709203F datasheet
+   *    @param apa_value 8-bit APA value to use for the attached battery
+   *    @return True on successful I2C write
+   */
+  bool setPackAPA(uint8_t apa_value) {
+    return writeRegister<LC709203F_CMD_APA>((uint16_t)apa_value);
+  }
+
+  /*!
+   *    @brief  Get IC LSI version
+   *    @return 16-bit value read from LC709203F_CMD_ICVERSION register, 0
+   *            if the read failed; tryICversion() tells the two apart
+   */
+  uint16_t getICversion(void) {
+    uint16_t vers = 0;
+    readRegister<LC709203F_CMD_ICVERSION>(&vers);
+    return vers;
+  }
+
+#ifndef LC709203F_NO_FLOAT
+  /*!
+   *    @brief  Get battery voltage
+   *    @return Floating point value read in Volts, 0 if the read failed;
+   *            see tryCellVoltage()
+   */
+  float cellVoltage(void) {
+    uint16_t voltage = 0;
+    readRegister<LC709203F_CMD_CELLVOLTAGE>(&voltage);
+    return voltage / 1000.0;
+  }
+
+  /*!
+   *    @brief  Get battery state in percent (0-100%)
+   *    @return Floating point value from 0 to 100.0, 0 if the read failed;
+   *            see tryCellPercent()
+   */
+  float cellPercent(void) {
+    uint16_t percent = 0;
+    readRegister<LC709203F_CMD_CELLITE>(&percent);
+    return percent / 10.0;
+  }
+#endif
+
+  /*!
+   *    @brief  Get battery voltage without floating point
+   *    @param millivolts Where to store the voltage in mV
+   *    @return True on successful I2C read
+   */
+  bool readCellVoltage(uint16_t *millivolts) {
+    return readRegister<LC709203F_CMD_CELLVOLTAGE>(millivolts);
+  }
+
+  /*!
+   *    @brief  Get battery state without floating point
+   *    @param tenths Where to store the state in 0.1% units (0-1000)
+   *    @return True on successful I2C read
+   */
+  bool readCellPercent(uint16_t *tenths) {
+    return readRegister<LC709203F_CMD_CELLITE>(tenths);
+  }
+
+  /*!
+   *    @brief  Get the thermistor B value (e.g. 3950)
+   *    @return The uint16_t B value
+   */
+  uint16_t getThermistorB(void) {
+    uint16_t val = 0;
+    readRegister<LC709203F_CMD_THERMISTORB>(&val);
+    return val;
+  }
+
+  /*!
+   *    @brief  Set the thermistor B value (e.g. 3950)
+   *    @param b The value to set it to
+   *    @return True on successful I2C write
+   */
+  bool setThermistorB(uint16_t b) {
+    return writeRegister<LC709203F_CMD_THERMISTORB>(b);
+  }
+
+  /*!
+   *    @brief  Get the battery profile parameter
+   *    @return The uint16_t profile value (0 or 1)
+   */
+  uint16_t getBattProfile(void) {
+    uint16_t val = 0;
+    readRegister<LC709203F_CMD_BATTPROF>(&val);
+    return val;
+  }
+
+  /*!
+   *    @brief  Set the battery profile parameter
+   *    @param b The value to set it to (0 or 1)
+   *    @return True on successful I2C write
+   */
+  bool setBattProfile(uint16_t b) {
+    return writeRegister<LC709203F_CMD_BATTPROF>(b);
+  }
+
+  /*!
+   *    @brief  Set the temperature mode (external or internal)
+   *    @param t The desired mode: LC709203F_TEMPERATURE_I2C or
+   *           LC709203F_TEMPERATURE_THERMISTOR
+   *    @return True on successful I2C write
+   */
+  bool setTemperatureMode(lc709203_tempmode_t t) {
+    return writeRegister<LC709203F_CMD_STATUSBIT>((uint16_t)t);
+  }
+
+  /*!
+   *    @brief  Get the temperature mode (external or internal)
+   *    @return LC709203F_TEMPERATURE_I2C or LC709203F_TEMPERATURE_THERMISTOR
+   */
+  lc709203_tempmode_t getTemperatureMode(void) {
+    uint16_t val = 0;
+    readRegister<LC709203F_CMD_STATUSBIT>(&val);
+    return (lc709203_tempmode_t)val;
+  }
+
+#ifndef LC709203F_NO_FLOAT
+  /*!
+   *    @brief  Get battery thermistor temperature
+   *    @return Floating point value from -20 to 60 *C, meaningless if the
+   *            read failed; see tryCellTemperature()
+   */
+  float getCellTemperature(void) {
+    uint16_t temp = 0;
+    readRegister<LC709203F_CMD_CELLTEMPERATURE>(&temp);
+    return lc709_temp_to_deci_celsius(temp) / 10.0;
+  }
+#endif
+
+  /*!
+   *    @brief  Get battery temperature without floating point
+   *    @param deci_kelvin Where to store the temperature in 0.1 K units
+   *    @return True on successful I2C read
+   */
+  bool readCellTemperature(uint16_t *deci_kelvin) {
+    return readRegister<LC709203F_CMD_CELLTEMPERATURE>(deci_kelvin);
+  }
+
+  /*!
+   *    @brief  Get battery temperature in 0.1 *C without floating point
+   *    @param deci_celsius Where to store the temperature, e.g. 253 = 25.3
+   *           *C
+   *    @return True on successful I2C read
+   */
+  bool readCellTemperatureC(int16_t *deci_celsius) {
+    uint16_t temp;
+    if (!readRegister<LC709203F_CMD_CELLTEMPERATURE>(&temp))
+      return false;
+    *deci_celsius = lc709_temp_to_deci_celsius(temp);
+    return true;
+  }
+
+  /*!
+   *    @brief  Tell the chip the cell temperature, when the temperature
+   *            mode is LC709203F_TEMPERATURE_I2C
+   *    @param deci_celsius Temperature in 0.1 *C, -200 to 600
+   *    @return True on successful I2C write, false if out of range
+   */
+  bool setCellTemperature(int16_t deci_celsius) {
+    if (deci_celsius < lc709_temp_to_deci_celsius(LC709203F_TEMP_MIN) ||
+        deci_celsius > lc709_temp_to_deci_celsius(LC709203F_TEMP_MAX))
+      return false;
+    return writeRegister<LC709203F_CMD_CELLTEMPERATURE>(
+        lc709_deci_celsius_to_temp(deci_celsius));
+  }
+
+  /*!
+   *    @brief  Get battery voltage, telling a failed read from a real value
+   *    @return Voltage in mV; LC709203F_ERR_RANGE outside
+   *            LC709203F_VOLTAGE_MIN to LC709203F_VOLTAGE_MAX
+   */
+  lc709203_result_t tryCellVoltage(void) {
+    return tryRegister<LC709203F_CMD_CELLVOLTAGE>(LC709203F_VOLTAGE_MIN,
+                                                  LC709203F_VOLTAGE_MAX);
+  }
+
+  /*!
+   *    @brief  Get battery state (ITE), telling a failed read from a real 0%
+   *    @return State in 0.1% units; LC709203F_ERR_RANGE above 1000
+   */
+  lc709203_result_t tryCellPercent(void) {
+    return tryRegister<LC709203F_CMD_CELLITE>(0, 1000);
+  }
+
+  /*!
+   *    @brief  Get relative state of charge, telling a failed read from 0%
+   *    @return RSOC in %; LC709203F_ERR_RANGE above 100
+   */
+  lc709203_result_t tryCellRSOC(void) {
+    return tryRegister<LC709203F_CMD_RSOC>(0, 100);
+  }
+
+  /*!
+   *    @brief  Get battery temperature, telling a failed read from a real
+   *            one
+   *    @return Temperature in 0.1 K, see lc709_temp_to_deci_celsius();
+   *            LC709203F_ERR_RANGE outside -20 to 60 *C
+   */
+  lc709203_result_t tryCellTemperature(void) {
+    return tryRegister<LC709203F_CMD_CELLTEMPERATURE>(LC709203F_TEMP_MIN,
+                                                      LC709203F_TEMP_MAX);
+  }
+
+  /*!
+   *    @brief  Get IC LSI version, telling a failed read from a real one
+   *    @return 16-bit value read from LC709203F_CMD_ICVERSION register
+   */
+  lc709203_result_t tryICversion(void) {
+    return tryRegister<LC709203F_CMD_ICVERSION>(0, 0xFFFF);
+  }
+
+  /*!
+   *    @brief  Read any register, telling why a read failed
+   *    @param command The I2C register/command
+   *    @return The raw register value
+   */
+  lc709203_result_t tryRead(uint8_t command) {
+    return tryRange(command, core.readPrefix(command), 0, 0xFFFF);
+  }
+
+  /*!
+   *    @brief  Get the battery APA value
+   *    @return The APA value currently in use
+   */
+  uint16_t getPackAPA(void) {
+    uint16_t val = 0;
+    readRegister<LC709203F_CMD_APA>(&val);
+    return val;
+  }
+
+  /*!
+   *    @brief  Retry failed register reads and writes. The chip NACKs a
+   *            write whose CRC it did not like, so writes are only retried
+   *            with LC709203F_RETRY_NACK. Retries block for their backoff,
+   *            which doubles from backoff_us up to max_backoff_us (65535 us
+   *            if that is 0); the budget bounds how long any one access
+   *            can take
+   *    @param policy The policy, NULL to turn retries off
+   */
+  void setRetryPolicy(const lc709203_retry_t *policy) {
+    if (policy) {
+      retry = *policy;
+      if (!retry.attempts)
+        retry.attempts = 1;
+    } else {
+      retry.attempts = 1;
+    }
+  }
+
+  /*!
+   *    @brief  Retries taken since construction or resetRetryCount()
+   *    @return Number of retries
+   */
+  uint32_t retryCount(void) const { return retries; }
+  /*!
+   *    @brief  Zero the retry count
+   */
+  void resetRetryCount(void) { retries = 0; }
+
+  /*!
+   *    @brief  Serve configuration getters (thermistor B, APA, profile, IC
+   *            version, alarms, power and temperature mode) from the last
+   *            value written or read instead of the bus. Live measurements
+   *            always go to the chip
+   *    @param enable True to use the shadow cache
+   */
+  void enableCache(bool enable = true) { cache_enabled = enable; }
+
+  /*!
+   *    @brief  Forget every shadowed register, e.g. after the chip was
+   *            power cycled behind the driver's back
+   */
+  void invalidateCache(void) { shadow_valid = 0; }
+
+  /*!
+   *    @brief  Re-read every shadowed register from the chip
+   *    @return True if all registers were read
+   */
+  bool refreshCache(void) {
+    static const uint8_t cmds[] = {
+        LC709203F_CMD_THERMISTORB, LC709203F_CMD_APA,
+        LC709203F_CMD_ICVERSION,   LC709203F_CMD_BATTPROF,
+        LC709203F_CMD_ALARMRSOC,   LC709203F_CMD_ALARMVOLT,
+        LC709203F_CMD_POWERMODE,   LC709203F_CMD_STATUSBIT,
+        LC709203F_CMD_PARAMETER};
+    uint16_t val;
+    bool ok = true;
+
+    invalidateCache();
+    for (uint8_t i = 0; i < sizeof(cmds); i++) {
+      ok &= readWord(cmds[i], &val);
+    }
+    return ok;
+  }
+
+  /*!
+   *    @brief  Read every live measurement register in one go. The reads
+   *            are handed to the transport as one batch, with CRC prefixes
+   *            folded at compile time, and a failed field does not stop
+   *            the rest from being read. The bus time is only lower on
+   *            transports that override write_then_read_batch(), such as
+   *            the Linux i2c-dev one; with BusIO on Arduino it still runs
+   *            one transfer per register, so it takes as long as four
+   *            single reads
+   *    @param snap Where to store the raw values and their validity bits
+   *    @return True if every field was read successfully
+   */
+  bool readSnapshot(lc709203_snapshot_t *snap) {
+    static const uint8_t cmds[] = {LC709203F_CMD_CELLVOLTAGE,
+                                   LC709203F_CMD_CELLITE, LC709203F_CMD_RSOC,
+                                   LC709203F_CMD_CELLTEMPERATURE};
+    static const uint8_t prefixes[] = {
+        lc709_crc8_read_prefix_ce(Address, LC709203F_CMD_CELLVOLTAGE),
+        lc709_crc8_read_prefix_ce(Address, LC709203F_CMD_CELLITE),
+        lc709_crc8_read_prefix_ce(Address, LC709203F_CMD_RSOC),
+        lc709_crc8_read_prefix_ce(Address, LC709203F_CMD_CELLTEMPERATURE)};
+    uint16_t *fields[] = {&snap->voltage, &snap->ite, &snap->rsoc,
+                          &snap->temperature};
+
+    // none of these are cached, so they can go to the bus as one batch
+    for (uint8_t i = 0; i < sizeof(cmds); i++)
+      *fields[i] = 0;
+    uint32_t start = instr ? bus_dev->nowMicros() : budgetStart();
+    uint8_t acked;
+    snap->valid = core.readWords(cmds, fields, sizeof(cmds), &acked, prefixes);
+#ifdef LC709203F_INSTRUMENT
+    if (instr) {
+      uint32_t each = (bus_dev->nowMicros() - start) / sizeof(cmds);
+      for (uint8_t i = 0; i < sizeof(cmds); i++)
+        record(cmds[i], each, acked & (1 << i), snap->valid & (1 << i));
+    }
+#endif
+
+    // registers the batch lost are retried one by one
+    for (uint8_t i = 0; retry.attempts > 1 && i < sizeof(cmds); i++) {
+      if (snap->valid & (1 << i))
+        continue;
+      lc709203_error_t err =
+          (acked & (1 << i)) ? LC709203F_ERR_CRC : LC709203F_ERR_NACK;
+      if (retryRead(cmds[i], prefixes[i], fields[i], err, start) ==
+          LC709203F_OK)
+        snap->valid |= 1 << i;
+      else
+        *fields[i] = 0;
+    }
+
+    if (sinks) {
+      lc709203_sample_t sample;
+      sample.timestamp = bus_dev->nowMillis();
+      sample.data = *snap;
+      for (Adafruit_LC709203F_SampleSink *s = sinks; s; s = s->next_sink)
+        s->addSample(sample);
+    }
+    return snap->valid == LC709203F_SNAPSHOT_ALL;
+  }
+
+  /*!
+   *    @brief  Record every snapshot into a sink (ring buffer, log,
+   *            stats...) as well as returning it. A sink can only be added
+   *            to one driver
+   *    @param sink The sink to add
+   */
+  void addSampleSink(Adafruit_LC709203F_SampleSink *sink) {
+    sink->next_sink = sinks;
+    sinks = sink;
+  }
+
+  /*!
+   *    @brief  Begin a non-blocking read of a register. The command write
+   *            and repeated-start read run in the background on transports
+   *            that support it; call pollRead() until it stops returning
+   *            LC709203F_XFER_BUSY
+   *    @param command The I2C register/command
+   *    @return True if the read was started, false if one is already
+   *            pending
+   */
+  bool startRead(uint8_t command) {
+    if (async_busy)
+      return false;
+
+    async_cmd = command;
+    async_start = bus_dev->nowMicros();
+    if (!bus_dev->startWriteThenRead(&async_cmd, 1, async_reply, 3))
+      return false;
+
+    async_busy = true;
+    return true;
+  }
+
+  /*!
+   *    @brief  Advance a read begun with startRead(), checking the CRC once
+   *            the reply has arrived
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return LC709203F_XFER_BUSY while the transfer runs,
+   *            LC709203F_XFER_DONE once data is valid, LC709203F_XFER_ERROR
+   *            on NACK or CRC failure or when the read timeout passes,
+   *            LC709203F_XFER_IDLE if no read was started
+   */
+  lc709203_xfer_state_t pollRead(uint16_t *data) {
+    if (!async_busy)
+      return LC709203F_XFER_IDLE;
+
+    lc709203_xfer_state_t state = bus_dev->pollTransfer();
+    if (state == LC709203F_XFER_BUSY) {
+      if (!async_timeout ||
+          bus_dev->nowMicros() - async_start < async_timeout)
+        return state;
+      // past the deadline, free the transport for the next read
+      bus_dev->cancelTransfer();
+    }
+
+    async_busy = false;
+    bool ok = state == LC709203F_XFER_DONE &&
+              core.decodeReply(core.readPrefix(async_cmd), async_reply, data);
+#ifdef LC709203F_INSTRUMENT
+    if (instr)
+      record(async_cmd, bus_dev->nowMicros() - async_start,
+             state == LC709203F_XFER_DONE, ok);
+#endif
+    return ok ? LC709203F_XFER_DONE : LC709203F_XFER_ERROR;
+  }
+
+  /*!
+   *    @brief  Set how long a startRead() may stay in flight before
+   *            pollRead() gives up on it, e.g. when a gauge holds the clock
+   *            low. The default is the 35 ms SMBus timeout
+   *    @param us Deadline in us, measured on the transport's clock, 0 to
+   *           wait forever
+   */
+  void setReadTimeout(uint32_t us) { async_timeout = us; }
+
+  /*!
+   *    @brief  Set the alarm pin to respond to an RSOC percentage level
+   *    @param percent The threshold value, set to 0 to disable alarm
+   *    @return True on successful I2C write
+   */
+  bool setAlarmRSOC(uint8_t percent) {
+    return writeRegister<LC709203F_CMD_ALARMRSOC>(percent);
+  }
+
+#ifndef LC709203F_NO_FLOAT
+  /*!
+   *    @brief  Set the alarm pin to respond to a battery voltage level
+   *    @param voltage The threshold value, set to 0 to disable alarm
+   *    @return True on successful I2C write
+   */
+  bool setAlarmVoltage(float voltage) {
+    return writeRegister<LC709203F_CMD_ALARMVOLT>(voltage * 1000);
+  }
+#endif
+
+  /*!
+   *    @brief  Set the alarm pin to respond to a battery voltage level
+   *    @param millivolts The threshold value in mV, set to 0 to disable
+   *           alarm
+   *    @return True on successful I2C write
+   */
+  bool setAlarmMillivolts(uint16_t millivolts) {
+    return writeRegister<LC709203F_CMD_ALARMVOLT>(millivolts);
+  }
+
+#if defined(ARDUINO)
+  /*!
+   *    @brief  Watch the (open drain, active low) ALARMB pin with an
+   *            interrupt instead of polling for the RSOC and voltage
+   *            thresholds. Only one LC709203F can be attached this way at a
+   *            time; for more, call alarmEdge() from your own interrupt
+   *            handlers and use onAlarm()
+   *    @param pin The GPIO connected to ALARMB, must support interrupts
+   *    @param callback Called from serviceAlarm() with the alarms that fired
+   *    @param debounce_ms How long ALARMB must stay low to count
+   *    @return True if the interrupt was attached, false if the pin has no
+   *            interrupt or another LC709203F is attached
+   */
+  bool attachAlarm(uint8_t pin, lc709203_alarm_callback_t callback,
+                   uint16_t debounce_ms = 10) {
+    int irq = digitalPinToInterrupt(pin);
+    if (irq < 0 || (lc709_alarm_flag && lc709_alarm_flag != &alarm_pending))
+      return false;
+
+    detachAlarm(); // moving to another pin
+    onAlarm(callback, debounce_ms);
+    alarm_pin = pin;
+    lc709_alarm_flag = &alarm_pending;
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(irq, lc709_alarm_isr, FALLING);
+    // already asserted before we started listening?
+    if (digitalRead(pin) == LOW)
+      alarmEdge();
+    return true;
+  }
+
+  /*!
+   *    @brief  Stop watching the ALARMB pin
+   */
+  void detachAlarm(void) {
+    if (alarm_pin >= 0)
+      detachInterrupt(digitalPinToInterrupt(alarm_pin));
+    alarm_pin = -1;
+    alarm_pending = false;
+    alarm_timing = false;
+    if (lc709_alarm_flag == &alarm_pending)
+      lc709_alarm_flag = NULL;
+  }
+#endif
+
+  /*!
+   *    @brief  Set the callback for alarms reported by serviceAlarm(), when
+   *            ALARMB edges are delivered through alarmEdge()
+   *    @param callback Called with the LC709203F_ALARM_* bits that fired
+   *    @param debounce_ms How long after an edge to confirm the alarm
+   */
+  void onAlarm(lc709203_alarm_callback_t callback, uint16_t debounce_ms = 10) {
+    alarm_cb = callback;
+    alarm_debounce = debounce_ms;
+  }
+
+  /*!
+   *    @brief  Note a falling edge on ALARMB. Safe to call from an
+   *            interrupt; the bus work happens later in serviceAlarm().
+   *            The store is done by lc709_alarm_edge(), which is placed in
+   *            RAM where the core needs that
+   */
+  void alarmEdge(void) { lc709_alarm_edge(&alarm_pending); }
+
+  /*!
+   *    @brief  Debounce a pending ALARMB edge, find out which threshold
+   *            fired and dispatch the callback. Call from the main loop; it
+   *            does no bus traffic unless an edge is pending
+   *    @return LC709203F_ALARM_* bits that fired, 0 if none (yet)
+   */
+  uint8_t serviceAlarm(void) {
+    if (!alarm_pending)
+      return 0;
+
+    uint32_t now = bus_dev->nowMillis();
+    if (!alarm_timing) {
+      alarm_timing = true;
+      alarm_since = now;
+    }
+    if ((uint32_t)(now - alarm_since) < alarm_debounce)
+      return 0;
+
+    alarm_pending = false;
+    alarm_timing = false;
+
+#if defined(ARDUINO)
+    // glitch: ALARMB did not stay low
+    if (alarm_pin >= 0 && digitalRead(alarm_pin) != LOW)
+      return 0;
+#endif
+
+    // the chip has no alarm status register, so compare against thresholds
+    uint8_t fired = 0;
+    uint16_t threshold, value;
+    if (readRegister<LC709203F_CMD_ALARMRSOC>(&threshold) && threshold &&
+        readRegister<LC709203F_CMD_RSOC>(&value) && value <= threshold)
+      fired |= LC709203F_ALARM_RSOC;
+    if (readRegister<LC709203F_CMD_ALARMVOLT>(&threshold) && threshold &&
+        readRegister<LC709203F_CMD_CELLVOLTAGE>(&value) && value < threshold)
+      fired |= LC709203F_ALARM_VOLTAGE;
+
+    if (fired && alarm_cb)
+      alarm_cb(fired);
+    return fired;
+  }
+
+  /*!
+   *    @brief  Keep bus health counters and latency histograms in caller
+   *            storage. Only possible when the library was built with
+   *            LC709203F_INSTRUMENT; the hooks are compiled out otherwise
+   *    @param storage Where to keep them, zeroed here; NULL to stop
+   *    @return False if the library was built without LC709203F_INSTRUMENT
+   *            and storage is not NULL
+   */
+  bool setInstrumentation(lc709203_instrument_t *storage) {
+#ifdef LC709203F_INSTRUMENT
+    instr = storage;
+    resetCounters();
+    return true;
+#else
+    instr = NULL;
+    return !storage;
+#endif
+  }
+
+  /*!
+   *    @brief  Bus health counters since setInstrumentation() or
+   *            resetCounters()
+   *    @return Pointer to the counters, NULL if none are kept
+   */
+  const lc709203_counters_t *counters(void) const {
+    return instr ? &instr->counters : NULL;
+  }
+
+  /*!
+   *    @brief  Copy out the latency histogram of a register
+   *    @param command The I2C register/command
+   *    @param buckets Array of LC709203F_LATENCY_BUCKETS counts, which
+   *           saturate at 65535
+   *    @return False for registers without a histogram, or if no
+   *            instrumentation storage is attached
+   */
+  bool getLatency(uint8_t command, uint16_t *buckets) const {
+    int8_t slot = lc709_stat_slot(command);
+    if (!instr || slot < 0)
+      return false;
+    memcpy(buckets, instr->latency[slot], sizeof(instr->latency[slot]));
+    return true;
+  }
+
+  /*!
+   *    @brief  Lowest latency counted in a histogram bucket
+   *    @param bucket Bucket index
+   *    @return Latency in us
+   */
+  static uint32_t latencyBucketFloor(uint8_t bucket) {
+    if (!bucket)
+      return 0;
+    uint8_t msb = 5 + (bucket - 1) / 2;
+    return (1UL << msb) | (((bucket - 1) & 1) ? 1UL << (msb - 1) : 0);
+  }
+
+  /*!
+   *    @brief  Zero the counters and histograms
+   */
+  void resetCounters(void) {
+    if (instr)
+      memset(instr, 0, sizeof(*instr));
+  }
+
+protected:
+  Bus *bus_dev = NULL;                      ///< Transport in use
+  Adafruit_LC709203F_Core<Bus, Address> core; ///< Word protocol over bus_dev
+  bool async_busy = false;    ///< A startRead() is waiting to be polled
+  uint8_t async_cmd;          ///< Command of the pending async read
+  uint8_t async_reply[3];     ///< Reply buffer of the pending async read
+  uint32_t async_start;       ///< When the pending async read started, us
+  uint32_t async_timeout = LC709203F_READ_TIMEOUT_US; ///< Its deadline, us
+  bool cache_enabled = false; ///< Serve config getters from the shadow
+  uint16_t shadow_valid = 0;  ///< Bit per shadow slot holding a known value
+  uint16_t shadow[LC709203F_SHADOW_REGS]; ///< Last known config registers
+  int16_t alarm_pin = -1;                    ///< ALARMB GPIO, -1 if none
+  lc709203_alarm_callback_t alarm_cb = NULL; ///< Alarm dispatch callback
+  uint16_t alarm_debounce = 10;              ///< ALARMB debounce in ms
+  volatile bool alarm_pending = false;       ///< Set by alarmEdge()
+  bool alarm_timing = false;                 ///< Debounce window running
+  uint32_t alarm_since;                      ///< Debounce window start
+  Adafruit_LC709203F_SampleSink *sinks = NULL; ///< Sample recorders
+  lc709203_retry_t retry = {1, 0, 0, 0, 0};    ///< Retry policy, none
+  uint32_t retries = 0;                        ///< Retries taken
+  lc709203_instrument_t *instr = NULL;         ///< Counters, NULL if none
+
+  /*!
+   *    @brief  Count one register transfer
+   *    @param command The I2C register/command
+   *    @param us How long it took
+   *    @param acked True if the bus transfer completed
+   *    @param ok True if it also passed the CRC check
+   */
+  void record(uint8_t command, uint32_t us, bool acked, bool ok) {
+    instr->counters.transactions++;
+    if (!acked)
+      instr->counters.nacks++;
+    else if (!ok)
+      instr->counters.crc_errors++;
+
+    int8_t slot = lc709_stat_slot(command);
+    if (slot >= 0) {
+      uint16_t &n = instr->latency[slot][lc709_latency_bucket(us)];
+      if (n != 0xFFFF)
+        n++;
+    }
+  }
+
+  /*!
+   *    @brief  One register read on the bus, no cache and no retries
+   *    @param command The I2C register/command
+   *    @param prefix CRC state after the read prefix of the command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return LC709203F_OK, or the reason the read failed
+   */
+  lc709203_error_t readOnce(uint8_t command, uint8_t prefix, uint16_t *data) {
+    bool acked;
+#ifdef LC709203F_INSTRUMENT
+    uint32_t start = instr ? bus_dev->nowMicros() : 0;
+#endif
+    bool ok = core.readWordPrefixed(command, prefix, data, &acked);
+#ifdef LC709203F_INSTRUMENT
+    if (instr)
+      record(command, bus_dev->nowMicros() - start, acked, ok);
+#endif
+    if (ok)
+      return LC709203F_OK;
+    if (acked)
+      return LC709203F_ERR_CRC;
+    return bus_dev->timedOut() ? LC709203F_ERR_TIMEOUT : LC709203F_ERR_NACK;
+  }
+
+  /*!
+   *    @brief  Retry a failed read as the retry policy allows
+   *    @param command The I2C register/command
+   *    @param prefix CRC state after the read prefix of the command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @param err Why the first try failed
+   *    @param start When the first try began, from budgetStart()
+   *    @return LC709203F_OK, or the reason the last try failed
+   */
+  lc709203_error_t retryRead(uint8_t command, uint8_t prefix, uint16_t *data,
+                             lc709203_error_t err, uint32_t start) {
+    uint16_t backoff = retry.backoff_us;
+    for (uint8_t attempt = 1;
+         err != LC709203F_OK && retryAfter(&err, attempt, start, &backoff);
+         attempt++)
+      err = readOnce(command, prefix, data);
+    return err;
+  }
+
+  /*!
+   *    @brief  When an access began, for the retry time budget. The clock
+   *            is only read if there is a budget, keeping it off the
+   *            polling path
+   *    @return Transport time in us, 0 without a budget
+   */
+  uint32_t budgetStart(void) {
+    return retry.budget_us ? bus_dev->nowMicros() : 0;
+  }
+
+  /*!
+   *    @brief  Decide whether a failed access gets another try, and wait
+   *            out the backoff if so
+   *    @param err Why the last try failed, set to LC709203F_ERR_TIMEOUT if
+   *           the time budget would run out
+   *    @param attempt Tries made so far
+   *    @param start When the first try began, from budgetStart()
+   *    @param backoff Wait before this retry, capped at max_backoff_us and
+   *           doubled for the next one
+   *    @return True to try again
+   */
+  bool retryAfter(lc709203_error_t *err, uint8_t attempt, uint32_t start,
+                  uint16_t *backoff) {
+    uint8_t kind =
+        *err == LC709203F_ERR_CRC ? LC709203F_RETRY_CRC : LC709203F_RETRY_NACK;
+    if (attempt >= retry.attempts || !(retry.retry_on & kind))
+      return false;
+    uint16_t cap = retry.max_backoff_us ? retry.max_backoff_us : 0xFFFF;
+    if (*backoff > cap)
+      *backoff = cap;
+    if (retry.budget_us &&
+        bus_dev->nowMicros() - start + *backoff >= retry.budget_us) {
+      *err = LC709203F_ERR_TIMEOUT;
+      return false;
+    }
+
+    if (*backoff)
+      bus_dev->delayMicros(*backoff);
+    *backoff = *backoff > cap / 2 ? cap : *backoff * 2;
+    retries++;
+#ifdef LC709203F_INSTRUMENT
+    if (instr)
+      instr->counters.retries++;
+#endif
+    return true;
+  }
+
+  /*!
+   *    @brief  readWord(), telling why a read failed
+   *    @param command The I2C register/command
+   *    @param prefix CRC state after the read prefix of the command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return LC709203F_OK, or the reason the read failed
+   */
+  lc709203_error_t readWordStatus(uint8_t command, uint8_t prefix,
+                                  uint16_t *data) {
+    int8_t slot = lc709_shadow_slot(command);
+
+    if (cache_enabled && slot >= 0 && (shadow_valid & (1 << slot))) {
+      *data = shadow[slot];
+      return LC709203F_OK;
+    }
+
+    uint32_t start = budgetStart();
+    lc709203_error_t err = readOnce(command, prefix, data);
+    if (err != LC709203F_OK)
+      err = retryRead(command, prefix, data, err, start);
+    if (err != LC709203F_OK)
+      return err;
+
+    if (slot >= 0) {
+      shadow[slot] = *data;
+      shadow_valid |= 1 << slot;
+    }
+    return LC709203F_OK;
+  }
+
+  /*!
+   *    @brief  Read a register and check it against a valid range
+   *    @param command The I2C register/command
+   *    @param prefix CRC state after the read prefix of the command
+   *    @param min Lowest valid value
+   *    @param max Highest valid value
+   *    @return The value, or 0 and the reason it could not be had
+   */
+  lc709203_result_t tryRange(uint8_t command, uint8_t prefix, uint16_t min,
+                             uint16_t max) {
+    lc709203_result_t r;
+    r.value = 0;
+    r.error = readWordStatus(command, prefix, &r.value);
+    if (r.error == LC709203F_OK && (r.value < min || r.value > max))
+      r.error = LC709203F_ERR_RANGE;
+    if (r.error != LC709203F_OK)
+      r.value = 0;
+    return r;
+  }
+
+  /*!
+   *    @brief  tryRange() on a register known at compile time
+   *    @tparam Command The I2C register/command
+   *    @param min Lowest valid value
+   *    @param max Highest valid value
+   *    @return The value, or 0 and the reason it could not be had
+   */
+  template <uint8_t Command>
+  lc709203_result_t tryRegister(uint16_t min, uint16_t max) {
+    constexpr uint8_t prefix = lc709_crc8_read_prefix_ce(Address, Command);
+    return tryRange(Command, prefix, min, max);
+  }
+
+  /*!
+   *    @brief  Helper that reads 16 bits of CRC data from the chip. Note
+   *            this function performs a CRC on data that includes the I2C
+   *            write address, command, read address and 2 bytes of response
+   *    @param command The I2C register/command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return True on successful I2C read
+   */
+  bool readWord(uint8_t command, uint16_t *data) {
+    return readWordStatus(command, core.readPrefix(command), data) ==
+           LC709203F_OK;
+  }
+
+  /*!
+   *    @brief  readWord() of a register known at compile time, with its CRC
+   *            prefix folded
+   *    @tparam Command The I2C register/command
+   *    @param data Pointer to uint16_t value we will store response
+   *    @return True on successful I2C read
+   */
+  template <uint8_t Command> bool readRegister(uint16_t *data) {
+    constexpr uint8_t prefix = lc709_crc8_read_prefix_ce(Address, Command);
+    return readWordStatus(Command, prefix, data) == LC709203F_OK;
+  }
+
+  /*!
+   *    @brief  Helper that writes 16 bits of CRC data to the chip. Note
+   *            this function performs a CRC on data that includes the I2C
+   *            write address, command, and 2 bytes of response
+   *    @param command The I2C register/command
+   *    @param prefix CRC state after the write prefix of the command
+   *    @param data Pointer to uint16_t value we will write to register
+   *    @return True on successful I2C write
+   */
+  bool writeWord(uint8_t command, uint8_t prefix, uint16_t data) {
+    uint32_t start = budgetStart();
+    uint16_t backoff = retry.backoff_us;
+    lc709203_error_t err = LC709203F_ERR_NACK;
+    bool ok;
+    for (uint8_t attempt = 1;; attempt++) {
+#ifdef LC709203F_INSTRUMENT
+      uint32_t begun = instr ? bus_dev->nowMicros() : 0;
+#endif
+      ok = core.writeWordPrefixed(command, prefix, data);
+#ifdef LC709203F_INSTRUMENT
+      if (instr)
+        record(command, bus_dev->nowMicros() - begun, ok, ok);
+#endif
+      if (ok || !retryAfter(&err, attempt, start, &backoff))
+        break;
+    }
+
+    // a failed write may or may not have landed, so drop the shadow
+    int8_t slot = lc709_shadow_slot(command);
+    if (slot >= 0) {
+      shadow[slot] = data;
+      if (ok)
+        shadow_valid |= 1 << slot;
+      else
+        shadow_valid &= ~(1 << slot);
+    }
+    return ok;
+  }
+
+  /*!
+   *    @brief  writeWord() of a register chosen at run time
+   *    @param command The I2C register/command
+   *    @param data Pointer to uint16_t value we will write to register
+   *    @return True on successful I2C write
+   */
+  bool writeWord(uint8_t command, uint16_t data) {
+    return writeWord(command, core.writePrefix(command), data);
+  }
+
+  /*!
+   *    @brief  writeWord() of a register known at compile time, with its
+   *            CRC prefix folded
+   *    @tparam Command The I2C register/command
+   *    @param data The value to write
+   *    @return True on successful I2C write
+   */
+  template <uint8_t Command> bool writeRegister(uint16_t data) {
+    constexpr uint8_t prefix = lc709_crc8_write_prefix_ce(Address, Command);
+    return writeWord(Command, prefix, data);
+  }
+};
+
+/*! The driver over any Adafruit_LC709203F_Transport, picked at run time */
+typedef Adafruit_LC709203F_Driver<Adafruit_LC709203F_Transport>
+    Adafruit_LC709203F_Generic;
+
+#endif
@@ -0,0 +1,332 @@
+/*!
+ *  @file Adafruit_LC709203F_Emulator.cpp
+ *
+ * 	Software model of the LC709203F for testing the driver without hardware
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Emulator.h"
+
+#if !defined(ARDUINO)
+
+#include "Adafruit_LC709203F_CRC.h"
+#include <string.h>
+
+/*! Open circuit voltage in mV for 0%, 10%, ... 100% charge */
+static const uint16_t lc709_emu_ocv[11] = {3000, 3450, 3600, 3680,
+                                           3740, 3790, 3840, 3900,
+                                           3970, 4070, 4200};
+
+#define LC709_EMU_IR_MOHM 100 ///< Internal resistance used for the IR drop
+
+/*!
+ *    @brief  Instantiates an emulated chip, fully charged, at 25 *C
+ *    @param addr The 7-bit I2C address the chip answers to
+ */
+Adafruit_LC709203F_Emulator::Adafruit_LC709203F_Emulator(uint8_t addr)
+    : _addr(addr), _now_us(0), _latency_us(0), _bus_hz(100000), _poll_us(10),
+      _xfer_done_us(0), _xfer_ok(false) {
+  reset();
+}
+
+/*!
+ *    @brief  Put the registers back to their power-on values
+ */
+void Adafruit_LC709203F_Emulator::reset(void) {
+  memset(_regs, 0, sizeof(_regs));
+  _regs[LC709203F_CMD_THERMISTORB] = 0x0D34;
+  _regs[LC709203F_CMD_CELLTEMPERATURE] = 0x0BA6; // 25 *C
+  _regs[LC709203F_CMD_ICVERSION] = 0x2717;
+  _regs[LC709203F_CMD_ALARMRSOC] = 0x0008;
+  _regs[LC709203F_CMD_POWERMODE] = LC709203F_POWER_OPERATE;
+  _regs[LC709203F_CMD_STATUSBIT] = LC709203F_TEMPERATURE_I2C;
+  _regs[LC709203F_CMD_PARAMETER] = 0x0301;
+  transactions = 0;
+  crc_errors = 0;
+  _nack_next = 0;
+  _corrupt_next = 0;
+  _load_ma = 0;
+  setBattery(500);
+}
+
+/*!
+ *    @brief  Set the fixed and per-bit cost of a transaction
+ *    @param us Fixed latency added to every transaction
+ *    @param bus_hz I2C clock used to compute the time spent on the wire
+ */
+void Adafruit_LC709203F_Emulator::setLatency(uint32_t us, uint32_t bus_hz) {
+  _latency_us = us;
+  _bus_hz = bus_hz ? bus_hz : 100000;
+}
+
+/*!
+ *    @brief  Time one transaction holds the bus
+ *    @param bytes Bytes on the wire, including address bytes
+ *    @return Microseconds
+ */
+uint32_t Adafruit_LC709203F_Emulator::transferTime(size_t bytes) const {
+  // 9 clocks per byte (8 data + ACK) plus start and stop
+  return _latency_us + ((bytes * 9 + 2) * 1000000UL + _bus_hz - 1) / _bus_hz;
+}
+
+/*!
+ *    @brief  Move virtual time forward without running the battery model
+ *    @param us Microseconds to advance
+ */
+void Adafruit_LC709203F_Emulator::advance(uint32_t us) { _now_us += us; }
+
+/*!
+ *    @brief  Virtual milliseconds since construction
+ *    @return Time in ms
+ */
+uint32_t Adafruit_LC709203F_Emulator::nowMillis(void) {
+  return (uint32_t)(_now_us / 1000);
+}
+
+/*!
+ *    @brief  Virtual microseconds since construction
+ *    @return Time in us
+ */
+uint32_t Adafruit_LC709203F_Emulator::nowMicros(void) {
+  return (uint32_t)_now_us;
+}
+
+/*!
+ *    @brief  Waiting on the emulator only moves virtual time
+ *    @param us Microseconds to wait
+ */
+void Adafruit_LC709203F_Emulator::delayMicros(uint32_t us) { advance(us); }
+
+/*!
+ *    @brief  Set the modelled cell size and state of charge
+ *    @param capacity_mah Cell capacity in mAh
+ *    @param percent_x10 State of charge in 0.1% units
+ */
+void Adafruit_LC709203F_Emulator::setBattery(uint16_t capacity_mah,
+                                             uint16_t percent_x10) {
+  if (percent_x10 > 1000)
+    percent_x10 = 1000;
+  _capacity_mams = (uint64_t)capacity_mah * 3600000UL;
+  _remaining_mams = _capacity_mams * percent_x10 / 1000;
+  updateMeasurements();
+}
+
+/*!
+ *    @brief  Run the battery model
+ *    @param ms Time to discharge (or charge, for a negative load) over
+ *    @param load_ma Current drawn from the cell in mA
+ */
+void Adafruit_LC709203F_Emulator::step(uint32_t ms, int16_t load_ma) {
+  uint64_t used = (uint64_t)(load_ma < 0 ? -load_ma : load_ma) * ms;
+  if (load_ma >= 0) {
+    _remaining_mams = used > _remaining_mams ? 0 : _remaining_mams - used;
+  } else {
+    _remaining_mams += used;
+    if (_remaining_mams > _capacity_mams)
+      _remaining_mams = _capacity_mams;
+  }
+  _load_ma = load_ma;
+  _now_us += (uint64_t)ms * 1000;
+  updateMeasurements();
+}
+
+/*!
+ *    @brief  Set the temperature seen by the thermistor
+ *    @param deci_kelvin Temperature in 0.1 K
+ */
+void Adafruit_LC709203F_Emulator::setTemperature(uint16_t deci_kelvin) {
+  if (_regs[LC709203F_CMD_STATUSBIT] == LC709203F_TEMPERATURE_THERMISTOR)
+    _regs[LC709203F_CMD_CELLTEMPERATURE] = deci_kelvin;
+}
+
+/*!
+ *    @brief  Recompute ITE, RSOC and cell voltage from the charge left
+ */
+void Adafruit_LC709203F_Emulator::updateMeasurements(void) {
+  uint16_t ite = 0;
+  if (_capacity_mams)
+    ite = (uint16_t)(_remaining_mams * 1000 / _capacity_mams);
+
+  uint8_t seg = ite / 100;
+  int32_t mv = lc709_emu_ocv[seg];
+  if (seg < 10)
+    mv += (int32_t)(lc709_emu_ocv[seg + 1] - lc709_emu_ocv[seg]) *
+          (ite % 100) / 100;
+  mv -= (int32_t)_load_ma * LC709_EMU_IR_MOHM / 1000;
+  if (mv < 0)
+    mv = 0;
+
+  _regs[LC709203F_CMD_CELLITE] = ite;
+  _regs[LC709203F_CMD_RSOC] = (ite + 5) / 10;
+  _regs[LC709203F_CMD_CELLVOLTAGE] = (uint16_t)mv;
+}
+
+/*!
+ *    @brief  Level of the open drain ALARMB output
+ *    @return False (low, asserted) while RSOC is at or below the RSOC alarm
+ *            or the voltage is below the voltage alarm
+ */
+bool Adafruit_LC709203F_Emulator::alarmLine(void) const {
+  uint16_t rsoc_alarm = _regs[LC709203F_CMD_ALARMRSOC];
+  uint16_t volt_alarm = _regs[LC709203F_CMD_ALARMVOLT];
+  if (rsoc_alarm && _regs[LC709203F_CMD_RSOC] <= rsoc_alarm)
+    return false;
+  if (volt_alarm && _regs[LC709203F_CMD_CELLVOLTAGE] < volt_alarm)
+    return false;
+  return true;
+}
+
+/*!
+ *    @brief  Read a register directly, bypassing the bus
+ *    @param command The register/command
+ *    @return The register value, 0 for unknown registers
+ */
+uint16_t Adafruit_LC709203F_Emulator::getRegister(uint8_t command) const {
+  return command < LC709203F_EMU_NUM_REGS ? _regs[command] : 0;
+}
+
+/*!
+ *    @brief  Write a register directly, bypassing the bus and its checks
+ *    @param command The register/command
+ *    @param value The value to store
+ */
+void Adafruit_LC709203F_Emulator::setRegister(uint8_t command,
+                                              uint16_t value) {
+  if (command < LC709203F_EMU_NUM_REGS)
+    _regs[command] = value;
+}
+
+/*!
+ *    @brief  Apply a word written over the bus
+ *    @param command The register/command
+ *    @param value The value written
+ *    @return False if the chip would NACK the write
+ */
+bool Adafruit_LC709203F_Emulator::acceptWrite(uint8_t command,
+                                              uint16_t value) {
+  switch (command) {
+  case LC709203F_CMD_INITRSOC:
+    if (value != 0xAA55)
+      return false;
+    updateMeasurements();
+    return true;
+  case LC709203F_CMD_CELLTEMPERATURE:
+    // only writable when the host supplies the temperature
+    if (_regs[LC709203F_CMD_STATUSBIT] != LC709203F_TEMPERATURE_I2C)
+      return false;
+    break;
+  case LC709203F_CMD_THERMISTORB:
+  case LC709203F_CMD_APA:
+  case LC709203F_CMD_BATTPROF:
+  case LC709203F_CMD_ALARMRSOC:
+  case LC709203F_CMD_ALARMVOLT:
+  case LC709203F_CMD_POWERMODE:
+  case LC709203F_CMD_STATUSBIT:
+    break;
+  default: // read only or unknown
+    return false;
+  }
+  _regs[command] = value;
+  return true;
+}
+
+/*!
+ *    @brief  Handle a word write: command, low byte, high byte, CRC
+ *    @param buffer Bytes written
+ *    @param len Number of bytes written
+ *    @return True if the chip ACKed the write
+ */
+bool Adafruit_LC709203F_Emulator::write(const uint8_t *buffer, size_t len) {
+  transactions++;
+  _now_us += transferTime(len + 1);
+  if (_nack_next) {
+    _nack_next--;
+    return false;
+  }
+  if (len != 4)
+    return false;
+
+  uint8_t crc =
+      lc709_crc8(buffer + 1, 2, lc709_crc8_write_prefix(_addr, buffer[0]));
+  if (crc != buffer[3]) {
+    crc_errors++;
+    return false;
+  }
+  return acceptWrite(buffer[0], buffer[1] | (uint16_t)buffer[2] << 8);
+}
+
+/*!
+ *    @brief  Handle a word read: command, repeated start, low, high, CRC
+ *    @param write_buffer The command byte
+ *    @param write_len Must be 1
+ *    @param read_buffer Where the reply goes
+ *    @param read_len Must be 3
+ *    @return True if the chip ACKed the read
+ */
+bool Adafruit_LC709203F_Emulator::write_then_read(const uint8_t *write_buffer,
+                                                  size_t write_len,
+                                                  uint8_t *read_buffer,
+                                                  size_t read_len) {
+  transactions++;
+  _now_us += transferTime(write_len + read_len + 2);
+  if (_nack_next) {
+    _nack_next--;
+    return false;
+  }
+  uint8_t command = write_buffer[0];
+  if (write_len != 1 || read_len != 3 || command < LC709203F_CMD_THERMISTORB ||
+      command >= LC709203F_EMU_NUM_REGS)
+    return false;
+
+  uint16_t value = _regs[command];
+  read_buffer[0] = value & 0xFF;
+  read_buffer[1] = value >> 8;
+
+  read_buffer[2] =
+      lc709_crc8(read_buffer, 2, lc709_crc8_read_prefix(_addr, command));
+  if (_corrupt_next) {
+    _corrupt_next--;
+    read_buffer[2] ^= 0x5A;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Start a read that completes once virtual time passes the
+ *            transaction time
+ *    @param write_buffer The command byte
+ *    @param write_len Must be 1
+ *    @param read_buffer Where the reply goes
+ *    @param read_len Must be 3
+ *    @return True if the transfer was started
+ */
+bool Adafruit_LC709203F_Emulator::startWriteThenRead(
+    const uint8_t *write_buffer, size_t write_len, uint8_t *read_buffer,
+    size_t read_len) {
+  if (xfer_state == LC709203F_XFER_BUSY)
+    return false;
+  // the reply is latched now, the clock is rewound so the caller has to
+  // wait (or advance()) for the bus time to pass
+  uint64_t start = _now_us;
+  _xfer_ok = write_then_read(write_buffer, write_len, read_buffer, read_len);
+  _xfer_done_us = _now_us;
+  _now_us = start;
+  xfer_state = LC709203F_XFER_BUSY;
+  return true;
+}
+
+/*!
+ *    @brief  Report on the transfer begun with startWriteThenRead()
+ *    @return LC709203F_XFER_BUSY until virtual time reaches completion
+ */
+lc709203_xfer_state_t Adafruit_LC709203F_Emulator::pollTransfer(void) {
+  if (xfer_state == LC709203F_XFER_BUSY) {
+    _now_us += _poll_us;
+    if (_now_us >= _xfer_done_us)
+      xfer_state = _xfer_ok ? LC709203F_XFER_DONE : LC709203F_XFER_ERROR;
+  }
+  return Adafruit_LC709203F_Transport::pollTransfer();
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,108 @@
+/*!
+ *  @file Adafruit_LC709203F_Emulator.h
+ *
+ * 	Software model of the LC709203F for testing the driver without hardware
+ *
+ * 	The emulator is a transport that answers the same byte protocol as the
+ * 	chip: CRC-checked word writes, word reads with a CRC appended, and the
+ * 	registers from LC709203F_CMD_THERMISTORB to LC709203F_CMD_PARAMETER.
+ * 	Time is virtual: every transaction advances an internal microsecond
+ * 	clock by a fixed latency plus the bit time on the bus, so throughput
+ * 	can be measured faster than real time. Polling a background transfer
+ * 	costs a little virtual time too, so a loop that only polls finishes.
+ *
+ * 	Only built on host builds, for the tests and benchmarks.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_EMULATOR_H
+#define _ADAFRUIT_LC709203F_EMULATOR_H
+
+#include "Adafruit_LC709203F.h"
+
+#if !defined(ARDUINO)
+
+#define LC709203F_EMU_NUM_REGS (LC709203F_CMD_PARAMETER + 1) ///< Reg space
+
+/*!
+ *    @brief  Emulated LC709203F with a simple battery discharge model
+ */
+class Adafruit_LC709203F_Emulator : public Adafruit_LC709203F_Transport {
+public:
+  Adafruit_LC709203F_Emulator(uint8_t addr = LC709203F_I2CADDR_DEFAULT);
+
+  void reset(void);
+
+  bool write(const uint8_t *buffer, size_t len);
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len);
+  bool startWriteThenRead(const uint8_t *write_buffer, size_t write_len,
+                          uint8_t *read_buffer, size_t read_len);
+  lc709203_xfer_state_t pollTransfer(void);
+
+  uint32_t nowMillis(void);
+  uint32_t nowMicros(void);
+  void delayMicros(uint32_t us);
+
+  void setLatency(uint32_t us, uint32_t bus_hz = 100000);
+  /*!
+   *    @brief  Set the virtual time each pollTransfer() call takes while a
+   *            transfer is in flight, standing in for the CPU time of the
+   *            polling loop
+   *    @param us Microseconds per poll, 0 to only move time by advance()
+   */
+  void setPollCost(uint32_t us) { _poll_us = us; }
+  void advance(uint32_t us);
+  /*!
+   *    @brief  Current virtual time, without wrapping
+   *    @return Microseconds since construction
+   */
+  uint64_t virtualMicros(void) const { return _now_us; }
+
+  void setBattery(uint16_t capacity_mah, uint16_t percent_x10 = 1000);
+  void step(uint32_t ms, int16_t load_ma);
+  void setTemperature(uint16_t deci_kelvin);
+
+  bool alarmLine(void) const;
+
+  uint16_t getRegister(uint8_t command) const;
+  void setRegister(uint8_t command, uint16_t value);
+
+  /*!
+   *    @brief  NACK the next transactions
+   *    @param n Number of transactions to fail
+   */
+  void injectNack(uint8_t n) { _nack_next = n; }
+  /*!
+   *    @brief  Corrupt the CRC byte of the next read replies
+   *    @param n Number of replies to corrupt
+   */
+  void injectCRCError(uint8_t n) { _corrupt_next = n; }
+
+  uint32_t transactions; ///< Number of transactions seen
+  uint32_t crc_errors;   ///< Writes rejected for a bad CRC
+
+private:
+  uint32_t transferTime(size_t bytes) const;
+  bool acceptWrite(uint8_t command, uint16_t value);
+  void updateMeasurements(void);
+
+  uint8_t _addr;
+  uint16_t _regs[LC709203F_EMU_NUM_REGS];
+  uint64_t _now_us;
+  uint32_t _latency_us;
+  uint32_t _bus_hz;
+  uint32_t _poll_us;
+  uint64_t _xfer_done_us;
+  bool _xfer_ok;
+  uint8_t _nack_next;
+  uint8_t _corrupt_next;
+  uint64_t _capacity_mams;  // full charge, in mA * ms
+  uint64_t _remaining_mams; // remaining charge, in mA * ms
+  int16_t _load_ma;
+};
+
+#endif // !ARDUINO
+
+#endif
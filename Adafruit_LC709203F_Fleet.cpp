@@ -0,0 +1,336 @@
+/*!
+ *  @file Adafruit_LC709203F_Fleet.cpp
+ *
+ * 	Many LC709203F gauges behind TCA9548A style I2C multiplexers
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Fleet.h"
+#include <string.h>
+
+/*!
+ *    @brief  Instantiates a mux
+ *    @param ctrl Transport bound to the mux's own address
+ *    @param same_bus Another mux on the same upstream bus, if any. Muxes
+ *           that share a bus close each other's channels, as only one
+ *           0x0B may be connected at a time
+ */
+Adafruit_LC709203F_Mux::Adafruit_LC709203F_Mux(
+    Adafruit_LC709203F_Transport *ctrl, Adafruit_LC709203F_Mux *same_bus)
+    : switches(0), _ctrl(ctrl), _selected(LC709203F_MUX_UNKNOWN) {
+  if (same_bus) {
+    _next = same_bus->_next;
+    same_bus->_next = this;
+  } else {
+    _next = this;
+  }
+}
+
+/*!
+ *    @brief  Connect one channel, unless it is already the one connected
+ *    @param channel Channel 0-7
+ *    @return True on success
+ */
+bool Adafruit_LC709203F_Mux::select(uint8_t channel) {
+  if (channel == _selected)
+    return true;
+
+  for (Adafruit_LC709203F_Mux *m = _next; m != this; m = m->_next)
+    if (!m->close())
+      return false;
+
+  uint8_t mask = 1 << (channel & 7);
+  switches++;
+  if (!_ctrl->write(&mask, 1)) {
+    _selected = LC709203F_MUX_UNKNOWN;
+    return false;
+  }
+  _selected = channel;
+  return true;
+}
+
+/*!
+ *    @brief  Disconnect all channels
+ *    @return True on success
+ */
+bool Adafruit_LC709203F_Mux::close(void) {
+  if (_selected == LC709203F_MUX_NONE)
+    return true;
+
+  uint8_t mask = 0;
+  switches++;
+  if (!_ctrl->write(&mask, 1)) {
+    _selected = LC709203F_MUX_UNKNOWN;
+    return false;
+  }
+  _selected = LC709203F_MUX_NONE;
+  return true;
+}
+
+/*!
+ *    @brief  Select the channel and check the gauge answers
+ *    @return True if the device is present
+ */
+bool Adafruit_LC709203F_MuxChannel::begin(void) {
+  return _mux->select(_channel) && _dev->begin();
+}
+
+/*!
+ *    @brief  Select the channel, then write
+ *    @param buffer Bytes to write
+ *    @param len Number of bytes to write
+ *    @return True if the device ACKed every byte
+ */
+bool Adafruit_LC709203F_MuxChannel::write(const uint8_t *buffer, size_t len) {
+  return _mux->select(_channel) && _dev->write(buffer, len);
+}
+
+/*!
+ *    @brief  Select the channel, then write and read
+ *    @param write_buffer Bytes to write
+ *    @param write_len Number of bytes to write
+ *    @param read_buffer Where to store the bytes read
+ *    @param read_len Number of bytes to read
+ *    @return True if the transfer completed
+ */
+bool Adafruit_LC709203F_MuxChannel::write_then_read(const uint8_t *write_buffer,
+                                                    size_t write_len,
+                                                    uint8_t *read_buffer,
+                                                    size_t read_len) {
+  return _mux->select(_channel) &&
+         _dev->write_then_read(write_buffer, write_len, read_buffer, read_len);
+}
+
+/*!
+ *    @brief  Select the channel, then run the batch
+ *    @param xfers The transfers, each one's 'ok' is set on return
+ *    @param count Number of transfers
+ *    @return True if every transfer completed
+ */
+bool Adafruit_LC709203F_MuxChannel::write_then_read_batch(
+    lc709203_xfer_t *xfers, size_t count) {
+  if (!_mux->select(_channel)) {
+    for (size_t i = 0; i < count; i++)
+      xfers[i].ok = false;
+    return false;
+  }
+  return _dev->write_then_read_batch(xfers, count);
+}
+
+/*!
+ *    @brief  Select the channel, then start the transfer on the bus. The
+ *            channel must stay selected until pollTransfer() is done
+ *    @param write_buffer Bytes to write, must stay valid until done
+ *    @param write_len Number of bytes to write
+ *    @param read_buffer Where to store the bytes read, must stay valid
+ *    @param read_len Number of bytes to read
+ *    @return True if the transfer was started
+ */
+bool Adafruit_LC709203F_MuxChannel::startWriteThenRead(
+    const uint8_t *write_buffer, size_t write_len, uint8_t *read_buffer,
+    size_t read_len) {
+  return _mux->select(_channel) &&
+         _dev->startWriteThenRead(write_buffer, write_len, read_buffer,
+                                  read_len);
+}
+
+/*!
+ *    @brief  Check on the transfer on the bus
+ *    @return State of the bus transport's transfer
+ */
+lc709203_xfer_state_t Adafruit_LC709203F_MuxChannel::pollTransfer(void) {
+  return _dev->pollTransfer();
+}
+
+/*!
+ *    @brief  Abandon the transfer on the bus
+ */
+void Adafruit_LC709203F_MuxChannel::cancelTransfer(void) {
+  _dev->cancelTransfer();
+}
+
+/*!
+ *    @brief  Whether the bus transport's last failure was a timeout
+ *    @return True for a timeout
+ */
+bool Adafruit_LC709203F_MuxChannel::timedOut(void) { return _dev->timedOut(); }
+
+/*!
+ *    @brief  The bus transport's clock
+ *    @return Monotonic time in ms
+ */
+uint32_t Adafruit_LC709203F_MuxChannel::nowMillis(void) {
+  return _dev->nowMillis();
+}
+
+/*!
+ *    @brief  The bus transport's clock
+ *    @return Monotonic time in us
+ */
+uint32_t Adafruit_LC709203F_MuxChannel::nowMicros(void) {
+  return _dev->nowMicros();
+}
+
+/*!
+ *    @brief  Wait using the bus transport
+ *    @param us Time to wait
+ */
+void Adafruit_LC709203F_MuxChannel::delayMicros(uint32_t us) {
+  _dev->delayMicros(us);
+}
+
+/*!
+ *    @brief  Instantiates a fleet over caller supplied storage
+ *    @param storage Array of 'capacity' members
+ *    @param capacity Most gauges the fleet can hold
+ */
+Adafruit_LC709203F_Fleet::Adafruit_LC709203F_Fleet(
+    lc709203_fleet_member_t *storage, uint8_t capacity)
+    : scans(0), _members(storage), _capacity(capacity), _count(0),
+      _buses(0), _reverse(false) {}
+
+/*!
+ *    @brief  Order members so gauges on a bus are contiguous, and within a
+ *            bus grouped by mux and sorted by channel
+ *    @param a A member
+ *    @param b Another member
+ *    @return True if a is visited before b
+ */
+static bool lc709_fleet_before(const lc709203_fleet_member_t &a,
+                               const lc709203_fleet_member_t &b) {
+  if (a.bus != b.bus)
+    return a.bus < b.bus;
+  if (a.mux != b.mux)
+    return (uintptr_t)a.mux < (uintptr_t)b.mux;
+  return a.channel < b.channel;
+}
+
+/*!
+ *    @brief  Add a gauge. Gauges on a mux should have been begun with an
+ *            Adafruit_LC709203F_MuxChannel for the same mux and channel
+ *    @param gauge The begun gauge
+ *    @param bus Number of the bus it is on; gauges on different buses are
+ *           read at the same time
+ *    @param mux Its mux, NULL if directly on the bus
+ *    @param channel Its mux channel
+ *    @return Index of its snapshot in the array scan() fills, or -1 if the
+ *            fleet is full or has LC709203F_FLEET_MAX_BUSES buses already
+ */
+int16_t Adafruit_LC709203F_Fleet::add(Adafruit_LC709203F_Generic *gauge,
+                                      uint8_t bus, Adafruit_LC709203F_Mux *mux,
+                                      uint8_t channel) {
+  if (_count >= _capacity)
+    return -1;
+
+  bool new_bus = true;
+  for (uint8_t i = 0; i < _count; i++)
+    if (_members[i].bus == bus)
+      new_bus = false;
+  if (new_bus && _buses >= LC709203F_FLEET_MAX_BUSES)
+    return -1;
+
+  lc709203_fleet_member_t m;
+  m.gauge = gauge;
+  m.mux = mux;
+  m.channel = channel;
+  m.bus = bus;
+  m.index = _count;
+
+  // insertion sort, the fleet is set up once
+  uint8_t i = _count;
+  while (i && lc709_fleet_before(m, _members[i - 1])) {
+    _members[i] = _members[i - 1];
+    i--;
+  }
+  _members[i] = m;
+  _count++;
+  if (new_bus)
+    _buses++;
+  return m.index;
+}
+
+/*!
+ *    @brief  Read voltage, ITE, RSOC and temperature of every gauge. A read
+ *            that fails, or outlasts its gauge's read timeout (see
+ *            Adafruit_LC709203F::setReadTimeout()), leaves that field
+ *            invalid and the scan moves on
+ *    @param snapshots Array of count() snapshots, filled in the order the
+ *           gauges were added
+ *    @return Number of gauges read completely
+ */
+uint8_t Adafruit_LC709203F_Fleet::scan(lc709203_snapshot_t *snapshots) {
+  static const uint8_t cmds[] = {LC709203F_CMD_CELLVOLTAGE,
+                                 LC709203F_CMD_CELLITE, LC709203F_CMD_RSOC,
+                                 LC709203F_CMD_CELLTEMPERATURE};
+
+  // one cursor per bus, walking its run of members
+  struct {
+    uint8_t pos;  // member being read
+    uint8_t left; // members still to read, including pos
+    uint8_t reg;  // index into cmds
+    bool busy;    // read in flight
+  } cur[LC709203F_FLEET_MAX_BUSES];
+
+  uint8_t buses = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!i || _members[i].bus != _members[i - 1].bus) {
+      cur[buses].pos = i;
+      cur[buses].left = 0;
+      cur[buses].reg = 0;
+      cur[buses].busy = false;
+      buses++;
+    }
+    cur[buses - 1].left++;
+    memset(&snapshots[_members[i].index], 0, sizeof(lc709203_snapshot_t));
+  }
+  if (_reverse) {
+    // start from the end the last scan left selected
+    for (uint8_t b = 0; b < buses; b++)
+      cur[b].pos += cur[b].left - 1;
+  }
+
+  uint8_t complete = 0;
+  uint8_t active = buses;
+  while (active) {
+    for (uint8_t b = 0; b < buses; b++) {
+      if (!cur[b].left)
+        continue;
+
+      lc709203_fleet_member_t &m = _members[cur[b].pos];
+      lc709203_snapshot_t &snap = snapshots[m.index];
+      uint16_t *fields[] = {&snap.voltage, &snap.ite, &snap.rsoc,
+                            &snap.temperature};
+
+      if (!cur[b].busy) {
+        cur[b].busy = m.gauge->startRead(cmds[cur[b].reg]);
+        if (cur[b].busy)
+          continue;
+      } else {
+        lc709203_xfer_state_t state = m.gauge->pollRead(fields[cur[b].reg]);
+        if (state == LC709203F_XFER_BUSY)
+          continue;
+        cur[b].busy = false;
+        if (state == LC709203F_XFER_DONE)
+          snap.valid |= 1 << cur[b].reg;
+      }
+
+      // this register is done, one way or the other
+      if (++cur[b].reg < sizeof(cmds))
+        continue;
+      if (snap.valid == LC709203F_SNAPSHOT_ALL)
+        complete++;
+      cur[b].reg = 0;
+      if (!--cur[b].left)
+        active--;
+      else if (_reverse)
+        cur[b].pos--;
+      else
+        cur[b].pos++;
+    }
+  }
+
+  _reverse = !_reverse;
+  scans++;
+  return complete;
+}
@@ -0,0 +1,147 @@
+/*!
+ *  @file Adafruit_LC709203F_Fleet.h
+ *
+ * 	Many LC709203F gauges behind TCA9548A style I2C multiplexers
+ *
+ * 	Every LC709203F answers at 0x0B, so gauges sharing a bus have to sit
+ * 	on different channels of a mux. Adafruit_LC709203F_MuxChannel is a
+ * 	transport that selects its channel before each transfer, skipping the
+ * 	mux write when the channel is already selected. Adafruit_LC709203F_Fleet
+ * 	reads a whole set of gauges into an array of snapshots, visiting them
+ * 	in mux channel order (reversed on every other scan so the channel left
+ * 	selected is read first) and keeping a read in flight on every bus at
+ * 	once.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_FLEET_H
+#define _ADAFRUIT_LC709203F_FLEET_H
+
+#include "Adafruit_LC709203F.h"
+
+#define LC709203F_MUX_ADDR_DEFAULT 0x70 ///< TCA9548A default i2c address
+#define LC709203F_MUX_NONE 0xFF         ///< No channel selected
+#define LC709203F_MUX_UNKNOWN 0xFE      ///< Selection not known, e.g. on boot
+
+#ifndef LC709203F_FLEET_MAX_BUSES
+#define LC709203F_FLEET_MAX_BUSES 4 ///< Buses a fleet reads in parallel
+#endif
+
+/*!
+ *    @brief  One TCA9548A style mux, remembering which channel is selected
+ */
+class Adafruit_LC709203F_Mux {
+public:
+  Adafruit_LC709203F_Mux(Adafruit_LC709203F_Transport *ctrl,
+                         Adafruit_LC709203F_Mux *same_bus = NULL);
+
+  bool select(uint8_t channel);
+  bool close(void);
+
+  /*!
+   *    @brief  Forget the cached selection, e.g. after the mux was reset,
+   *            so the next select() writes it again
+   */
+  void invalidate(void) { _selected = LC709203F_MUX_UNKNOWN; }
+
+  /*!
+   *    @brief  The channel currently selected
+   *    @return Channel 0-7, LC709203F_MUX_NONE or LC709203F_MUX_UNKNOWN
+   */
+  uint8_t selected(void) const { return _selected; }
+
+  uint32_t switches; ///< Mux writes done, a measure of scheduling quality
+
+private:
+  Adafruit_LC709203F_Transport *_ctrl;
+  Adafruit_LC709203F_Mux *_next; // ring of the muxes sharing the bus
+  uint8_t _selected;
+};
+
+/*!
+ *    @brief  Transport for one gauge on one mux channel
+ */
+class Adafruit_LC709203F_MuxChannel : public Adafruit_LC709203F_Transport {
+public:
+  /*!
+   *    @brief  Bind a channel of a mux to the bus transport behind it
+   *    @param dev Transport to 0x0B on the mux's upstream bus, can be shared
+   *           by every channel of the mux
+   *    @param mux The mux
+   *    @param channel Channel the gauge is wired to, 0-7
+   */
+  Adafruit_LC709203F_MuxChannel(Adafruit_LC709203F_Transport *dev,
+                                Adafruit_LC709203F_Mux *mux, uint8_t channel)
+      : _dev(dev), _mux(mux), _channel(channel) {}
+
+  bool begin(void);
+  bool write(const uint8_t *buffer, size_t len);
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len);
+  bool write_then_read_batch(lc709203_xfer_t *xfers, size_t count);
+  bool startWriteThenRead(const uint8_t *write_buffer, size_t write_len,
+                          uint8_t *read_buffer, size_t read_len);
+  lc709203_xfer_state_t pollTransfer(void);
+  void cancelTransfer(void);
+  bool timedOut(void);
+  uint32_t nowMillis(void);
+  uint32_t nowMicros(void);
+  void delayMicros(uint32_t us);
+
+  /*!
+   *    @brief  The mux this channel belongs to
+   *    @return Pointer to the mux
+   */
+  Adafruit_LC709203F_Mux *mux(void) const { return _mux; }
+
+  /*!
+   *    @brief  The mux channel
+   *    @return Channel number
+   */
+  uint8_t channel(void) const { return _channel; }
+
+private:
+  Adafruit_LC709203F_Transport *_dev;
+  Adafruit_LC709203F_Mux *_mux;
+  uint8_t _channel;
+};
+
+/*!  One gauge of a fleet, see Adafruit_LC709203F_Fleet::add() */
+typedef struct {
+  Adafruit_LC709203F_Generic *gauge; ///< The begun gauge
+  Adafruit_LC709203F_Mux *mux;       ///< Its mux, NULL if directly on the bus
+  uint8_t channel;                   ///< Mux channel
+  uint8_t bus;                       ///< Bus number
+  uint8_t index;                     ///< Position in the snapshot array
+} lc709203_fleet_member_t;
+
+/*!
+ *    @brief  Reads many gauges across buses and muxes into one array
+ */
+class Adafruit_LC709203F_Fleet {
+public:
+  Adafruit_LC709203F_Fleet(lc709203_fleet_member_t *storage,
+                           uint8_t capacity);
+
+  int16_t add(Adafruit_LC709203F_Generic *gauge, uint8_t bus = 0,
+              Adafruit_LC709203F_Mux *mux = NULL, uint8_t channel = 0);
+  uint8_t scan(lc709203_snapshot_t *snapshots);
+
+  /*!
+   *    @brief  Gauges in the fleet
+   *    @return Count, also the size of the array scan() fills
+   */
+  uint8_t count(void) const { return _count; }
+
+  uint32_t scans; ///< Completed scans
+
+private:
+  lc709203_fleet_member_t *_members; // sorted by bus, mux, channel
+  uint8_t _capacity;
+  uint8_t _count;
+  uint8_t _buses;
+  bool _reverse;
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*!
+ *  @file Adafruit_LC709203F_LinuxI2C.cpp
+ *
+ * 	Linux i2c-dev transport for the Adafruit LC709203F driver
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_LinuxI2C.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/*!
+ *    @brief  Instantiates a transport, call begin() to open the adapter
+ *    @param path Adapter device, e.g. "/dev/i2c-1". Not copied
+ *    @param address The 7-bit I2C address
+ */
+Adafruit_LC709203F_LinuxI2C::Adafruit_LC709203F_LinuxI2C(const char *path,
+                                                         uint8_t address)
+    : syscalls(0), fd(-1), addr(address), timed_out(false), _path(path) {}
+
+/*!
+ *    @brief  Closes the adapter
+ */
+Adafruit_LC709203F_LinuxI2C::~Adafruit_LC709203F_LinuxI2C() { end(); }
+
+/*!
+ *    @brief  Open the adapter and check it can do combined transfers
+ *    @return True if the adapter is usable
+ */
+bool Adafruit_LC709203F_LinuxI2C::begin(void) {
+  if (fd < 0)
+    fd = open(_path, O_RDWR);
+  if (fd < 0)
+    return false;
+
+  unsigned long funcs = 0;
+  syscalls++;
+  if (ioctl(fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C)) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Close the adapter
+ */
+void Adafruit_LC709203F_LinuxI2C::end(void) {
+  if (fd >= 0)
+    close(fd);
+  fd = -1;
+}
+
+/*!
+ *    @brief  Issue messages as one combined transaction, with repeated
+ *            starts between them and a single stop at the end. Test
+ *            harnesses override this to stand in for the adapter
+ *    @param msgs The messages
+ *    @param count Number of messages, at most I2C_RDWR_IOCTL_MAX_MSGS
+ *    @return True if every message was ACKed
+ */
+bool Adafruit_LC709203F_LinuxI2C::transfer(struct i2c_msg *msgs,
+                                           size_t count) {
+  struct i2c_rdwr_ioctl_data data;
+  data.msgs = msgs;
+  data.nmsgs = count;
+  syscalls++;
+  if (ioctl(fd, I2C_RDWR, &data) == (int)count)
+    return true;
+  timed_out = errno == ETIMEDOUT;
+  return false;
+}
+
+/*!
+ *    @brief  Write bytes to the device in one transaction
+ *    @param buffer Bytes to write
+ *    @param len Number of bytes to write
+ *    @return True if the device ACKed every byte
+ */
+bool Adafruit_LC709203F_LinuxI2C::write(const uint8_t *buffer, size_t len) {
+  struct i2c_msg msg;
+  msg.addr = addr;
+  msg.flags = 0;
+  msg.len = len;
+  msg.buf = (uint8_t *)buffer;
+  return transfer(&msg, 1);
+}
+
+/*!
+ *    @brief  Write bytes, then read with a repeated start, in one ioctl
+ *    @param write_buffer Bytes to write
+ *    @param write_len Number of bytes to write
+ *    @param read_buffer Where to store the bytes read
+ *    @param read_len Number of bytes to read
+ *    @return True if the transfer completed
+ */
+bool Adafruit_LC709203F_LinuxI2C::write_then_read(const uint8_t *write_buffer,
+                                                  size_t write_len,
+                                                  uint8_t *read_buffer,
+                                                  size_t read_len) {
+  struct i2c_msg msgs[2];
+  msgs[0].addr = addr;
+  msgs[0].flags = 0;
+  msgs[0].len = write_len;
+  msgs[0].buf = (uint8_t *)write_buffer;
+  msgs[1].addr = addr;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = read_len;
+  msgs[1].buf = read_buffer;
+  return transfer(msgs, 2);
+}
+
+/*!
+ *    @brief  Run write-then-reads as few ioctls as the kernel allows. The
+ *            kernel gives up on the whole ioctl at the first NACK, so if a
+ *            batch fails its transfers are redone one by one to find out
+ *            which of them actually failed
+ *    @param xfers The transfers, each one's 'ok' is set on return
+ *    @param count Number of transfers
+ *    @return True if every transfer completed
+ */
+bool Adafruit_LC709203F_LinuxI2C::write_then_read_batch(lc709203_xfer_t *xfers,
+                                                        size_t count) {
+  struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+  const size_t per_ioctl = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+  bool all = true;
+
+  for (size_t first = 0; first < count; first += per_ioctl) {
+    size_t n = count - first < per_ioctl ? count - first : per_ioctl;
+    for (size_t i = 0; i < n; i++) {
+      lc709203_xfer_t &x = xfers[first + i];
+      msgs[2 * i].addr = addr;
+      msgs[2 * i].flags = 0;
+      msgs[2 * i].len = x.write_len;
+      msgs[2 * i].buf = (uint8_t *)x.write_buffer;
+      msgs[2 * i + 1].addr = addr;
+      msgs[2 * i + 1].flags = I2C_M_RD;
+      msgs[2 * i + 1].len = x.read_len;
+      msgs[2 * i + 1].buf = x.read_buffer;
+    }
+
+    bool ok = transfer(msgs, 2 * n);
+    for (size_t i = 0; i < n; i++) {
+      lc709203_xfer_t &x = xfers[first + i];
+      x.ok = ok || transfer(&msgs[2 * i], 2);
+      all = all && x.ok;
+    }
+  }
+  return all;
+}
+
+#endif // __linux__ && !ARDUINO
@@ -0,0 +1,63 @@
+/*!
+ *  @file Adafruit_LC709203F_LinuxI2C.h
+ *
+ * 	Linux i2c-dev transport for the Adafruit LC709203F driver
+ *
+ * 	Talks to /dev/i2c-N with the I2C_RDWR ioctl, so a register read is
+ * 	the command write and the 3 byte read joined by a repeated start in a
+ * 	single system call, exactly like write_then_read() on Arduino. A batch
+ * 	of reads, such as the four of readSnapshot(), goes out as one ioctl
+ * 	too.
+ *
+ * 	Only built on Linux host builds.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_LINUXI2C_H
+#define _ADAFRUIT_LC709203F_LINUXI2C_H
+
+#include "Adafruit_LC709203F.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <linux/i2c.h>
+
+/*!
+ *    @brief  Transport over a Linux i2c-dev adapter
+ */
+class Adafruit_LC709203F_LinuxI2C : public Adafruit_LC709203F_Transport {
+public:
+  Adafruit_LC709203F_LinuxI2C(const char *path,
+                              uint8_t address = LC709203F_I2CADDR_DEFAULT);
+  virtual ~Adafruit_LC709203F_LinuxI2C();
+
+  bool begin(void);
+  void end(void);
+  bool write(const uint8_t *buffer, size_t len);
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len);
+  bool write_then_read_batch(lc709203_xfer_t *xfers, size_t count);
+
+  /*!
+   *    @brief  Did the last failed ioctl fail with ETIMEDOUT?
+   *    @return True for a timeout
+   */
+  bool timedOut(void) { return timed_out; }
+
+  uint32_t syscalls; ///< ioctl calls made, for tuning
+
+protected:
+  virtual bool transfer(struct i2c_msg *msgs, size_t count);
+
+  int fd;         ///< Adapter file descriptor, -1 when closed
+  uint8_t addr;   ///< 7-bit device address
+  bool timed_out; ///< Last failed transfer() hit the adapter timeout
+
+private:
+  const char *_path;
+};
+
+#endif // __linux__ && !ARDUINO
+
+#endif
@@ -0,0 +1,254 @@
+/*!
+ *  @file Adafruit_LC709203F_Log.cpp
+ *
+ * 	Compact block log format for LC709203F samples
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Log.h"
+#include "Adafruit_LC709203F_CRC.h"
+
+/*!
+ *    @brief  Append an unsigned LEB128 varint
+ *    @param out Where to write, needs up to 5 bytes
+ *    @param v The value
+ *    @return Bytes written
+ */
+static uint8_t lc709_put_varint(uint8_t *out, uint32_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (v & 0x7F) | 0x80;
+    v >>= 7;
+  }
+  out[n++] = v;
+  return n;
+}
+
+/*!
+ *    @brief  Read an unsigned LEB128 varint
+ *    @param in The encoded bytes
+ *    @param avail Bytes available at 'in'
+ *    @param v Where to store the value
+ *    @return Bytes consumed, 0 if truncated or too long
+ */
+static uint8_t lc709_get_varint(const uint8_t *in, uint16_t avail,
+                                uint32_t *v) {
+  uint32_t r = 0;
+  for (uint8_t n = 0; n < 5 && n < avail; n++) {
+    r |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+    if (!(in[n] & 0x80)) {
+      *v = r;
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+/*!
+ *    @brief  Zig-zag encode the difference of two register values
+ *    @param cur New value
+ *    @param prev Previous value
+ *    @return Small unsigned number for small differences of either sign
+ */
+static uint32_t lc709_zigzag(uint16_t cur, uint16_t prev) {
+  int32_t d = (int32_t)cur - prev;
+  return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+/*!
+ *    @brief  Undo lc709_zigzag()
+ *    @param z Encoded difference
+ *    @param prev Previous value
+ *    @return New value
+ */
+static uint16_t lc709_unzigzag(uint32_t z, uint16_t prev) {
+  int32_t d = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+  return (uint16_t)(prev + d);
+}
+
+/*!
+ *    @brief  Store a little endian word
+ *    @param out Where to write
+ *    @param v The value
+ */
+static void lc709_put16(uint8_t *out, uint16_t v) {
+  out[0] = v & 0xFF;
+  out[1] = v >> 8;
+}
+
+/*!
+ *    @brief  Load a little endian word
+ *    @param in Where to read
+ *    @return The value
+ */
+static uint16_t lc709_get16(const uint8_t *in) {
+  return in[0] | (uint16_t)in[1] << 8;
+}
+
+/*!
+ *    @brief  Instantiates an encoder over a caller supplied block buffer
+ *    @param block Buffer for the block being built
+ *    @param block_size Size of the buffer, at least LC709203F_LOG_MIN_BLOCK
+ *    @param on_block Called with each sealed block
+ *    @param ctx Passed to on_block
+ *    @param keyframe_interval Seal the block after this many samples, so
+ *           a lost block loses at most this much history
+ */
+Adafruit_LC709203F_LogEncoder::Adafruit_LC709203F_LogEncoder(
+    uint8_t *block, uint16_t block_size, lc709203_log_block_fn on_block,
+    void *ctx, uint8_t keyframe_interval)
+    : samples(0), bytes(0), _block(block), _size(block_size), _pos(0),
+      _count(0), _keyframe_interval(keyframe_interval ? keyframe_interval : 1),
+      _on_block(on_block), _ctx(ctx), _prev() {}
+
+/*!
+ *    @brief  Encode one sample, sealing the block first if it is full
+ *    @param sample The sample to log
+ *    @return False if the block buffer is too small to be used
+ */
+bool Adafruit_LC709203F_LogEncoder::add(const lc709203_sample_t &sample) {
+  if (_size < LC709203F_LOG_MIN_BLOCK)
+    return false;
+
+  const lc709203_snapshot_t &d = sample.data;
+  uint32_t dt = sample.timestamp - _prev.timestamp;
+
+  if (_count && (_count >= _keyframe_interval || dt >= 0x80000000UL ||
+                 _pos + LC709203F_LOG_MAX_SAMPLE + 1 > _size))
+    flush();
+
+  if (!_count) {
+    // keyframe
+    _block[0] = LC709203F_LOG_MAGIC;
+    _block[4] = sample.timestamp & 0xFF;
+    _block[5] = sample.timestamp >> 8;
+    _block[6] = sample.timestamp >> 16;
+    _block[7] = sample.timestamp >> 24;
+    lc709_put16(_block + 8, d.voltage);
+    lc709_put16(_block + 10, d.ite);
+    lc709_put16(_block + 12, d.rsoc);
+    lc709_put16(_block + 14, d.temperature);
+    _block[16] = d.valid;
+    _pos = LC709203F_LOG_HEADER;
+  } else {
+    const lc709203_snapshot_t &p = _prev.data;
+    bool valid_changed = d.valid != p.valid;
+    _pos += lc709_put_varint(_block + _pos, dt << 1 | valid_changed);
+    if (valid_changed)
+      _block[_pos++] = d.valid;
+    _pos += lc709_put_varint(_block + _pos, lc709_zigzag(d.voltage, p.voltage));
+    _pos += lc709_put_varint(_block + _pos, lc709_zigzag(d.ite, p.ite));
+    _pos += lc709_put_varint(_block + _pos, lc709_zigzag(d.rsoc, p.rsoc));
+    _pos += lc709_put_varint(_block + _pos,
+                             lc709_zigzag(d.temperature, p.temperature));
+  }
+
+  _prev = sample;
+  _count++;
+  samples++;
+  return true;
+}
+
+/*!
+ *    @brief  Seal the current block (count, length, CRC) and hand it to the
+ *            block callback. Call before power down to keep the tail
+ *    @return Length of the sealed block, 0 if it was empty
+ */
+uint16_t Adafruit_LC709203F_LogEncoder::flush(void) {
+  if (!_count)
+    return 0;
+
+  uint16_t len = _pos + 1;
+  _block[1] = _count;
+  lc709_put16(_block + 2, len);
+  _block[_pos] = lc709_crc8(_block, _pos);
+
+  if (_on_block)
+    _on_block(_ctx, _block, len);
+  bytes += len;
+  _count = 0;
+  _pos = 0;
+  return len;
+}
+
+/*!
+ *    @brief  Check a block and get ready to decode it
+ *    @param block The block bytes
+ *    @param len Bytes available, at least the block length
+ *    @return False if the block is not a valid log block
+ */
+bool Adafruit_LC709203F_LogDecoder::begin(const uint8_t *block,
+                                          uint16_t len) {
+  _count = _read = 0;
+  if (len < LC709203F_LOG_HEADER + 1 || block[0] != LC709203F_LOG_MAGIC)
+    return false;
+
+  uint16_t blen = lc709_get16(block + 2);
+  if (blen < LC709203F_LOG_HEADER + 1 || blen > len || !block[1])
+    return false;
+  if (lc709_crc8(block, blen - 1) != block[blen - 1])
+    return false;
+
+  _block = block;
+  _end = blen - 1;
+  _pos = LC709203F_LOG_HEADER;
+  _count = block[1];
+
+  // a damaged length field can point at a byte that happens to match the
+  // CRC, so the samples must also fill the block exactly
+  lc709203_sample_t sample;
+  while (next(&sample))
+    ;
+  if (_read != _count || _pos != _end) {
+    _count = _read = 0;
+    return false;
+  }
+  _pos = LC709203F_LOG_HEADER;
+  _read = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Decode the next sample of the block
+ *    @param sample Where to store it
+ *    @return False at the end of the block or on a malformed block
+ */
+bool Adafruit_LC709203F_LogDecoder::next(lc709203_sample_t *sample) {
+  if (_read >= _count)
+    return false;
+
+  if (!_read) {
+    const uint8_t *k = _block + 4;
+    _prev.timestamp = k[0] | (uint32_t)k[1] << 8 | (uint32_t)k[2] << 16 |
+                      (uint32_t)k[3] << 24;
+    _prev.data.voltage = lc709_get16(_block + 8);
+    _prev.data.ite = lc709_get16(_block + 10);
+    _prev.data.rsoc = lc709_get16(_block + 12);
+    _prev.data.temperature = lc709_get16(_block + 14);
+    _prev.data.valid = _block[16];
+  } else {
+    uint32_t v[5];
+    for (uint8_t i = 0; i < 5; i++) {
+      uint8_t n = lc709_get_varint(_block + _pos, _end - _pos, &v[i]);
+      if (!n)
+        return false;
+      _pos += n;
+      if (i == 0 && (v[0] & 1)) {
+        if (_pos >= _end)
+          return false;
+        _prev.data.valid = _block[_pos++];
+      }
+    }
+    lc709203_snapshot_t &p = _prev.data;
+    _prev.timestamp += v[0] >> 1;
+    p.voltage = lc709_unzigzag(v[1], p.voltage);
+    p.ite = lc709_unzigzag(v[2], p.ite);
+    p.rsoc = lc709_unzigzag(v[3], p.rsoc);
+    p.temperature = lc709_unzigzag(v[4], p.temperature);
+  }
+
+  *sample = _prev;
+  _read++;
+  return true;
+}
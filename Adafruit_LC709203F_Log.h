@@ -0,0 +1,94 @@
+/*!
+ *  @file Adafruit_LC709203F_Log.h
+ *
+ * 	Compact block log format for LC709203F samples
+ *
+ * 	Samples are packed into fixed size blocks (e.g. one flash page). Each
+ * 	block starts with a keyframe holding the first sample in full; every
+ * 	following sample is stored as the zig-zag varint encoded difference
+ * 	from the one before, which is usually one byte per channel. A block
+ * 	ends with the CRC8 used by the LC709203F protocol, so a torn or worn
+ * 	page is detected on decode. Blocks decode independently.
+ *
+ * 	Block layout:
+ * 	  magic (1) | sample count (1) | block length (2, LE)
+ * 	  keyframe: timestamp (4) voltage (2) ite (2) rsoc (2) temperature (2)
+ * 	            valid (1)
+ * 	  per sample: varint(dt << 1 | valid changed) [valid (1)]
+ * 	              zigzag varints of dvoltage, dite, drsoc, dtemperature
+ * 	  crc8 (1)
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_LOG_H
+#define _ADAFRUIT_LC709203F_LOG_H
+
+#include "Adafruit_LC709203F.h"
+
+#define LC709203F_LOG_MAGIC 0xB7    ///< First byte of every block
+#define LC709203F_LOG_HEADER 17     ///< Header plus keyframe size
+#define LC709203F_LOG_MIN_BLOCK 32  ///< Smallest useful block size
+#define LC709203F_LOG_MAX_SAMPLE 18 ///< Worst case delta encoding size
+
+/*! Called with each sealed block, ready to be written to flash */
+typedef void (*lc709203_log_block_fn)(void *ctx, const uint8_t *block,
+                                      uint16_t len);
+
+/*!
+ *    @brief  Packs samples into CRC protected delta/varint blocks
+ */
+class Adafruit_LC709203F_LogEncoder : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_LogEncoder(uint8_t *block, uint16_t block_size,
+                                lc709203_log_block_fn on_block,
+                                void *ctx = NULL,
+                                uint8_t keyframe_interval = 255);
+
+  bool add(const lc709203_sample_t &sample);
+  uint16_t flush(void);
+
+  /*!
+   *    @brief  Sink interface: encode every sample the driver reads
+   *    @param sample The sample just read
+   */
+  void addSample(const lc709203_sample_t &sample) { add(sample); }
+
+  uint32_t samples; ///< Samples encoded so far
+  uint32_t bytes;   ///< Bytes in sealed blocks so far
+
+private:
+  uint8_t *_block;
+  uint16_t _size;
+  uint16_t _pos;
+  uint8_t _count;
+  uint8_t _keyframe_interval;
+  lc709203_log_block_fn _on_block;
+  void *_ctx;
+  lc709203_sample_t _prev;
+};
+
+/*!
+ *    @brief  Unpacks one block written by Adafruit_LC709203F_LogEncoder
+ */
+class Adafruit_LC709203F_LogDecoder {
+public:
+  bool begin(const uint8_t *block, uint16_t len);
+  bool next(lc709203_sample_t *sample);
+
+  /*!
+   *    @brief  Samples in the block
+   *    @return Count from the block header
+   */
+  uint8_t count(void) const { return _count; }
+
+private:
+  const uint8_t *_block;
+  uint16_t _end;
+  uint16_t _pos;
+  uint8_t _count;
+  uint8_t _read;
+  lc709203_sample_t _prev;
+};
+
+#endif
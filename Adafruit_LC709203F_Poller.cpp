@@ -0,0 +1,160 @@
+/*!
+ *  @file Adafruit_LC709203F_Poller.cpp
+ *
+ * 	Adaptive polling for the Adafruit LC709203F Battery Monitor
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Poller.h"
+
+/*!
+ *    @brief  Instantiates a poller over a gauge of any bus type
+ *    @param gauge The begun LC709203F to poll
+ *    @param read Reads a snapshot from it
+ *    @param min_ms Shortest interval, used during transients
+ *    @param max_ms Longest interval, reached while readings are stable
+ */
+Adafruit_LC709203F_Poller::Adafruit_LC709203F_Poller(void *gauge, read_fn read,
+                                                     uint32_t min_ms,
+                                                     uint32_t max_ms)
+    : polls(0), _gauge(gauge), _read(read), _have_last(false), _next(0),
+      _stable_mv(10), _stable_ite(5), _alarm_mv(0), _margin_mv(0),
+      _alarm_rsoc(0), _margin_rsoc(0), _budget(0), _budget_used(0),
+      _budget_window(0), _budget_start(0) {
+  setIntervals(min_ms, max_ms);
+}
+
+/*!
+ *    @brief  Set the interval range
+ *    @param min_ms Shortest interval, used during transients
+ *    @param max_ms Longest interval, reached while readings are stable
+ */
+void Adafruit_LC709203F_Poller::setIntervals(uint32_t min_ms,
+                                             uint32_t max_ms) {
+  _min_ms = min_ms ? min_ms : 1;
+  _max_ms = max_ms < _min_ms ? _min_ms : max_ms;
+  _interval = _min_ms;
+}
+
+/*!
+ *    @brief  Set the change between polls the interval is tuned for. More
+ *            than a band halves the interval, under half a band grows it,
+ *            and four bands (a load transient) drops to the minimum
+ *    @param millivolts Voltage band, in mV
+ *    @param ite ITE band, in 0.1%
+ */
+void Adafruit_LC709203F_Poller::setStableBand(uint16_t millivolts,
+                                              uint16_t ite) {
+  _stable_mv = millivolts;
+  _stable_ite = ite;
+}
+
+/*!
+ *    @brief  Poll at the minimum interval close to these levels, usually
+ *            the same thresholds given to setAlarmMillivolts() and
+ *            setAlarmRSOC(). Like the chip's alarm, the percentage is
+ *            compared with RSOC
+ *    @param millivolts Voltage alarm level in mV, 0 to ignore
+ *    @param rsoc RSOC alarm level in whole %, 0 to ignore
+ *    @param margin_mv How close to the voltage level counts as near, in mV
+ *    @param margin_rsoc How close to the RSOC level counts as near, in %
+ */
+void Adafruit_LC709203F_Poller::setAlarmLevels(uint16_t millivolts,
+                                               uint8_t rsoc,
+                                               uint16_t margin_mv,
+                                               uint8_t margin_rsoc) {
+  _alarm_mv = millivolts;
+  _margin_mv = margin_mv;
+  _alarm_rsoc = rsoc;
+  _margin_rsoc = margin_rsoc;
+}
+
+/*!
+ *    @brief  Cap the bus traffic: at most max_polls snapshots per window
+ *    @param max_polls Snapshots allowed per window, 0 for no cap
+ *    @param window_ms Window length
+ */
+void Adafruit_LC709203F_Poller::setBusBudget(uint16_t max_polls,
+                                             uint32_t window_ms) {
+  _budget = max_polls;
+  _budget_window = window_ms;
+  _budget_used = 0;
+}
+
+/*!
+ *    @brief  Are the last readings within the margin of an alarm level?
+ *    @return True if so
+ */
+bool Adafruit_LC709203F_Poller::nearAlarm(void) const {
+  if (_alarm_mv && (_last.valid & LC709203F_SNAPSHOT_VOLTAGE) &&
+      _last.voltage <= (uint32_t)_alarm_mv + _margin_mv)
+    return true;
+  if (_alarm_rsoc && (_last.valid & LC709203F_SNAPSHOT_RSOC) &&
+      _last.rsoc <= (uint16_t)_alarm_rsoc + _margin_rsoc)
+    return true;
+  return false;
+}
+
+/*!
+ *    @brief  Take a snapshot if one is due and adapt the interval
+ *    @param now_ms Current time, e.g. millis()
+ *    @return True if a new snapshot was taken, see last()
+ */
+bool Adafruit_LC709203F_Poller::poll(uint32_t now_ms) {
+  if (polls && (int32_t)(now_ms - _next) < 0)
+    return false;
+
+  if (_budget) {
+    if ((uint32_t)(now_ms - _budget_start) >= _budget_window) {
+      _budget_start = now_ms;
+      _budget_used = 0;
+    }
+    if (_budget_used >= _budget) {
+      _next = _budget_start + _budget_window;
+      return false;
+    }
+    _budget_used++;
+  }
+
+  lc709203_snapshot_t snap;
+  bool ok = _read(_gauge, &snap);
+  polls++;
+
+  if (!ok) {
+    // try again soon, but keep the last good values
+    _interval = _min_ms;
+  } else {
+    // how far each reading moved, as a multiple of its band, x2
+    uint8_t change = 8; // first reading: treat as a transient
+    if (_have_last) {
+      uint16_t dv = snap.voltage > _last.voltage ? snap.voltage - _last.voltage
+                                                 : _last.voltage - snap.voltage;
+      uint16_t dite = snap.ite > _last.ite ? snap.ite - _last.ite
+                                           : _last.ite - snap.ite;
+      uint32_t cv = (uint32_t)dv * 2 / (_stable_mv ? _stable_mv : 1);
+      uint32_t ci = (uint32_t)dite * 2 / (_stable_ite ? _stable_ite : 1);
+      uint32_t c = cv > ci ? cv : ci;
+      change = c > 8 ? 8 : c;
+    }
+    _last = snap;
+    _have_last = true;
+
+    if (change >= 8 || nearAlarm()) {
+      // load transient or close to an alarm: poll as fast as allowed
+      _interval = _min_ms;
+    } else if (change >= 2) {
+      // moved more than a band since last time, tighten
+      _interval /= 2;
+    } else if (change == 0) {
+      // moved less than half a band, back off by 1.5x
+      _interval += _interval / 2 + 1;
+    }
+    if (_interval < _min_ms)
+      _interval = _min_ms;
+    if (_interval > _max_ms)
+      _interval = _max_ms;
+  }
+  _next = now_ms + _interval;
+  return ok;
+}
@@ -0,0 +1,86 @@
+/*!
+ *  @file Adafruit_LC709203F_Poller.h
+ *
+ * 	Adaptive polling for the Adafruit LC709203F Battery Monitor
+ *
+ * 	The LC709203F updates its measurements slowly, so polling at a fixed,
+ * 	fast rate mostly re-reads the same values. The poller stretches the
+ * 	interval while voltage and ITE are stable, drops back to the minimum on
+ * 	load transients or close to alarm thresholds, and can cap the number
+ * 	of snapshots taken per time window.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_POLLER_H
+#define _ADAFRUIT_LC709203F_POLLER_H
+
+#include "Adafruit_LC709203F.h"
+
+/*!
+ *    @brief  Rate-of-change driven polling scheduler for one LC709203F
+ */
+class Adafruit_LC709203F_Poller {
+public:
+  /*!
+   *    @brief  Instantiates a poller; the first call to poll() reads at once
+   *    @param gauge The begun LC709203F to poll, any Adafruit_LC709203F_Driver
+   *           instantiation
+   *    @param min_ms Shortest interval, used during transients
+   *    @param max_ms Longest interval, reached while readings are stable
+   */
+  template <class Gauge>
+  Adafruit_LC709203F_Poller(Gauge *gauge, uint32_t min_ms = 1000,
+                            uint32_t max_ms = 60000)
+      : Adafruit_LC709203F_Poller(gauge, readGauge<Gauge>, min_ms, max_ms) {}
+
+  void setIntervals(uint32_t min_ms, uint32_t max_ms);
+  void setStableBand(uint16_t millivolts, uint16_t ite);
+  void setAlarmLevels(uint16_t millivolts, uint8_t rsoc, uint16_t margin_mv,
+                      uint8_t margin_rsoc);
+  void setBusBudget(uint16_t max_polls, uint32_t window_ms);
+
+  bool poll(uint32_t now_ms);
+
+  /*!
+   *    @brief  The most recent snapshot taken
+   *    @return Reference to the snapshot
+   */
+  const lc709203_snapshot_t &last(void) const { return _last; }
+  /*!
+   *    @brief  Interval that will be used after the next poll
+   *    @return Milliseconds
+   */
+  uint32_t interval(void) const { return _interval; }
+  /*!
+   *    @brief  When the next poll is due
+   *    @return Time in ms, on the same clock passed to poll()
+   */
+  uint32_t nextPoll(void) const { return _next; }
+
+  uint32_t polls; ///< Snapshots taken so far
+
+private:
+  typedef bool (*read_fn)(void *gauge, lc709203_snapshot_t *snap);
+
+  Adafruit_LC709203F_Poller(void *gauge, read_fn read, uint32_t min_ms,
+                            uint32_t max_ms);
+  template <class Gauge>
+  static bool readGauge(void *gauge, lc709203_snapshot_t *snap) {
+    return static_cast<Gauge *>(gauge)->readSnapshot(snap);
+  }
+  bool nearAlarm(void) const;
+
+  void *_gauge;
+  read_fn _read;
+  lc709203_snapshot_t _last;
+  bool _have_last;
+  uint32_t _min_ms, _max_ms, _interval, _next;
+  uint16_t _stable_mv, _stable_ite;
+  uint16_t _alarm_mv, _margin_mv;
+  uint8_t _alarm_rsoc, _margin_rsoc;
+  uint16_t _budget, _budget_used;
+  uint32_t _budget_window, _budget_start;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*!
+ *  @file Adafruit_LC709203F_Runtime.cpp
+ *
+ * 	Time-to-empty / time-to-full estimation for the LC709203F
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Runtime.h"
+
+#ifndef LC709203F_NO_FLOAT
+
+#include <math.h>
+
+/*!
+ *    @brief  Instantiates an estimator
+ *    @param time_constant_s Age in seconds at which a sample's weight has
+ *           dropped to 1/e. Longer is smoother, shorter follows load
+ *           changes faster
+ *    @param z Width of the confidence bounds in standard errors
+ */
+Adafruit_LC709203F_Runtime::Adafruit_LC709203F_Runtime(float time_constant_s,
+                                                       float z)
+    : _tau(time_constant_s > 0 ? time_constant_s : 1), _z(z) {
+  reset();
+}
+
+/*!
+ *    @brief  Forget all history, e.g. after swapping the battery
+ */
+void Adafruit_LC709203F_Runtime::reset(void) {
+  _have_last = false;
+  _last_ms = 0;
+  _last_pct = 0;
+  _w = _w2 = _x = _y = _xx = _xy = _yy = 0;
+}
+
+/*!
+ *    @brief  Update the fit with a sample. Samples without a valid ITE
+ *            reading are ignored
+ *    @param sample The sample, in time order
+ */
+void Adafruit_LC709203F_Runtime::addSample(const lc709203_sample_t &sample) {
+  if (!(sample.data.valid & LC709203F_SNAPSHOT_ITE))
+    return;
+
+  float pct = sample.data.ite / 10.0f;
+  if (_have_last) {
+    float dt = (uint32_t)(sample.timestamp - _last_ms) / 1000.0f;
+    float dy = pct - _last_pct;
+    float d = expf(-dt / _tau);
+
+    // move the origin to the new sample, then age the old samples
+    _xx = d * (_xx - 2 * dt * _x + dt * dt * _w);
+    _xy = d * (_xy - dy * _x - dt * _y + dt * dy * _w);
+    _yy = d * (_yy - 2 * dy * _y + dy * dy * _w);
+    _x = d * (_x - dt * _w);
+    _y = d * (_y - dy * _w);
+    _w *= d;
+    _w2 *= d * d;
+  }
+  // the new sample sits at the origin, so it only adds weight
+  _w += 1;
+  _w2 += 1;
+  _last_ms = sample.timestamp;
+  _last_pct = pct;
+  _have_last = true;
+}
+
+/*!
+ *    @brief  Convert an estimate to whole seconds
+ *    @param s Seconds, may be negative or not finite
+ *    @return Seconds, LC709203F_RUNTIME_UNKNOWN if not representable
+ */
+static uint32_t lc709_runtime_seconds(float s) {
+  if (!(s >= 0) || s >= 4.0e9f)
+    return LC709203F_RUNTIME_UNKNOWN;
+  return (uint32_t)(s + 0.5f);
+}
+
+/*!
+ *    @brief  Get the current estimate
+ *    @param result Where to store the estimate
+ *    @return False until enough history has been seen to fit a line
+ */
+bool Adafruit_LC709203F_Runtime::estimate(lc709203_runtime_t *result) const {
+  // effective number of samples under the weights
+  float n = _w2 > 0 ? _w * _w / _w2 : 0;
+  if (n < 3)
+    return false;
+
+  float mx = _x / _w;
+  float my = _y / _w;
+  float cxx = _xx - _x * mx;
+  float cxy = _xy - _x * my;
+  float cyy = _yy - _y * my;
+  if (!(cxx > 0))
+    return false;
+
+  float slope = cxy / cxx; // % per second
+  float pct = _last_pct + my - slope * mx;
+
+  // residual variance, floored at the 0.1% quantization noise of ITE
+  float sse = cyy - slope * cxy;
+  float var = sse > 0 ? sse / _w * n / (n - 2) : 0;
+  if (var < 0.01f / 12)
+    var = 0.01f / 12;
+  float se = sqrtf(var * (_w2 / _w) / cxx);
+  float lo = slope - _z * se;
+  float hi = slope + _z * se;
+  // the fitted level is uncertain too, and never better than half an ITE
+  // step, as ITE truncates and averaging can't recover the lost part
+  float dp = _z * sqrtf(var * (1 / n + mx * mx * (_w2 / _w) / cxx)) + 0.05f;
+
+  if (pct < 0)
+    pct = 0;
+  if (pct > 100)
+    pct = 100;
+  result->percent = pct;
+  result->rate = slope * 3600;
+
+  if (lo < 0 && hi > 0) {
+    // flat, or too noisy to tell
+    result->state = LC709203F_RUNTIME_IDLE;
+    result->seconds = result->seconds_min = result->seconds_max =
+        LC709203F_RUNTIME_UNKNOWN;
+  } else if (slope < 0) {
+    result->state = LC709203F_RUNTIME_DISCHARGING;
+    result->seconds = lc709_runtime_seconds(pct / -slope);
+    result->seconds_min =
+        lc709_runtime_seconds(pct > dp ? (pct - dp) / -lo : 0);
+    result->seconds_max = lc709_runtime_seconds((pct + dp) / -hi);
+  } else {
+    result->state = LC709203F_RUNTIME_CHARGING;
+    result->seconds = lc709_runtime_seconds((100 - pct) / slope);
+    result->seconds_min =
+        lc709_runtime_seconds(100 - pct > dp ? (100 - pct - dp) / hi : 0);
+    result->seconds_max = lc709_runtime_seconds((100 - pct + dp) / lo);
+  }
+  return true;
+}
+
+#endif // LC709203F_NO_FLOAT
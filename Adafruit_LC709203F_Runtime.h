@@ -0,0 +1,71 @@
+/*!
+ *  @file Adafruit_LC709203F_Runtime.h
+ *
+ * 	Time-to-empty / time-to-full estimation for the LC709203F
+ *
+ * 	Fits a line to the ITE (cellPercent()) history with an exponentially
+ * 	weighted least squares regression, so older samples fade out with a
+ * 	configurable time constant. The fit is updated in place from a few
+ * 	running sums, so each sample costs a fixed handful of float operations
+ * 	and no history is kept. The confidence bounds come from the standard
+ * 	errors of the slope and the fitted level, plus half an ITE step.
+ *
+ * 	The estimator is a sample sink: attach it to the driver on the device,
+ * 	or feed it samples from a recorded trace (e.g. decoded log blocks) on
+ * 	a host. It needs floating point and is left out when
+ * 	LC709203F_NO_FLOAT is defined.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_RUNTIME_H
+#define _ADAFRUIT_LC709203F_RUNTIME_H
+
+#include "Adafruit_LC709203F.h"
+
+#ifndef LC709203F_NO_FLOAT
+
+#define LC709203F_RUNTIME_UNKNOWN 0xFFFFFFFFUL ///< No finite estimate
+
+/*!  Direction of the fitted trend */
+typedef enum {
+  LC709203F_RUNTIME_IDLE,        ///< No significant trend (yet)
+  LC709203F_RUNTIME_DISCHARGING, ///< seconds is the time to empty
+  LC709203F_RUNTIME_CHARGING,    ///< seconds is the time to full
+} lc709203_runtime_state_t;
+
+/*!  Result of Adafruit_LC709203F_Runtime::estimate() */
+typedef struct {
+  lc709203_runtime_state_t state; ///< Trend direction
+  float percent;                  ///< Fitted state of charge now, %
+  float rate;                     ///< Fitted change, % per hour
+  uint32_t seconds;               ///< Best estimate of time to empty / full
+  uint32_t seconds_min;           ///< Lower confidence bound
+  uint32_t seconds_max;           ///< Upper bound, may be UNKNOWN
+} lc709203_runtime_t;
+
+/*!
+ *    @brief  Online exponentially weighted regression of ITE over time
+ */
+class Adafruit_LC709203F_Runtime : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_Runtime(float time_constant_s = 600, float z = 2);
+
+  void reset(void);
+  void addSample(const lc709203_sample_t &sample);
+  bool estimate(lc709203_runtime_t *result) const;
+
+private:
+  float _tau;
+  float _z;
+  bool _have_last;
+  uint32_t _last_ms;
+  float _last_pct;
+  // weighted sums, with x in seconds and y in % both relative to the
+  // newest sample, which keeps them small enough for single precision
+  float _w, _w2, _x, _y, _xx, _xy, _yy;
+};
+
+#endif // LC709203F_NO_FLOAT
+
+#endif
@@ -0,0 +1,82 @@
+/*!
+ *  @file Adafruit_LC709203F_SampleRing.cpp
+ *
+ * 	Lock-free single-producer/single-consumer ring of LC709203F samples
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_SampleRing.h"
+
+// The indices run freely and are masked on use. Each side publishes its
+// index with a release store after touching the slot, and reads the other
+// side's index with an acquire load, so a slot is never read while it is
+// being written.
+#define LC709_LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)      ///< acquire
+#define LC709_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE) ///< release
+
+/*!
+ *    @brief  Wrap caller supplied storage
+ *    @param storage Array of at least 'capacity' samples
+ *    @param capacity Number of slots in storage. Only a power of two of them
+ *           are used, rounding down: 100 slots hold 64 samples, so size the
+ *           storage as a power of two. A ring of 0 slots (or with NULL
+ *           storage) is always full
+ */
+Adafruit_LC709203F_SampleRing::Adafruit_LC709203F_SampleRing(
+    lc709203_sample_t *storage, lc709_ring_index_t capacity)
+    : _buf(capacity ? storage : NULL), _dropped(0), _head(0), _tail(0) {
+  lc709_ring_index_t size = 1;
+  while ((lc709_ring_index_t)(size << 1) != 0 &&
+         (lc709_ring_index_t)(size << 1) <= capacity)
+    size <<= 1;
+  _mask = size - 1;
+}
+
+/*!
+ *    @brief  Add a sample. Producer side only
+ *    @param sample The sample to copy in
+ *    @return False if the ring was full and the sample was dropped
+ */
+bool Adafruit_LC709203F_SampleRing::push(const lc709203_sample_t &sample) {
+  lc709_ring_index_t head = _head;
+  if (!_buf || (lc709_ring_index_t)(head - LC709_LOAD(&_tail)) > _mask) {
+    LC709_STORE(&_dropped, (lc709_ring_index_t)(_dropped + 1));
+    return false;
+  }
+  _buf[head & _mask] = sample;
+  LC709_STORE(&_head, (lc709_ring_index_t)(head + 1));
+  return true;
+}
+
+/*!
+ *    @brief  Take the oldest sample. Consumer side only
+ *    @param sample Where to copy the sample
+ *    @return False if the ring was empty
+ */
+bool Adafruit_LC709203F_SampleRing::pop(lc709203_sample_t *sample) {
+  lc709_ring_index_t tail = _tail;
+  if (tail == LC709_LOAD(&_head))
+    return false;
+  *sample = _buf[tail & _mask];
+  LC709_STORE(&_tail, (lc709_ring_index_t)(tail + 1));
+  return true;
+}
+
+/*!
+ *    @brief  Number of samples waiting. Exact from the consumer side, a
+ *            lower bound of the free space from the producer side
+ *    @return Samples in the ring
+ */
+lc709_ring_index_t Adafruit_LC709203F_SampleRing::available(void) const {
+  return LC709_LOAD(&_head) - LC709_LOAD(&_tail);
+}
+
+/*!
+ *    @brief  Samples lost to a full ring. Safe to read from either side;
+ *            wraps at the index width (256 on AVR)
+ *    @return Dropped samples
+ */
+lc709_ring_index_t Adafruit_LC709203F_SampleRing::dropped(void) const {
+  return LC709_LOAD(&_dropped);
+}
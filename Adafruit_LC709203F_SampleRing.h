@@ -0,0 +1,62 @@
+/*!
+ *  @file Adafruit_LC709203F_SampleRing.h
+ *
+ * 	Lock-free single-producer/single-consumer ring of LC709203F samples
+ *
+ * 	One context (a polling task or an ISR) pushes samples, typically by
+ * 	adding the ring as a sample sink of the driver, and another context
+ * 	(e.g. telemetry) pops them. Neither side takes a lock or disables
+ * 	interrupts. Storage is supplied by the caller so the size is fixed at
+ * 	compile time and nothing is allocated. The ring uses a power of two
+ * 	slots: other sizes are rounded down, so 100 slots of storage hold 64
+ * 	samples.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_SAMPLERING_H
+#define _ADAFRUIT_LC709203F_SAMPLERING_H
+
+#include "Adafruit_LC709203F.h"
+
+#if defined(__AVR__)
+typedef uint8_t lc709_ring_index_t; ///< Single byte loads are atomic on AVR
+#else
+typedef uint32_t lc709_ring_index_t; ///< Naturally atomic index width
+#endif
+
+/*!
+ *    @brief  SPSC ring buffer of timestamped samples
+ */
+class Adafruit_LC709203F_SampleRing : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_SampleRing(lc709203_sample_t *storage,
+                                lc709_ring_index_t capacity);
+
+  bool push(const lc709203_sample_t &sample);
+  bool pop(lc709203_sample_t *sample);
+  lc709_ring_index_t available(void) const;
+  lc709_ring_index_t dropped(void) const;
+
+  /*!
+   *    @brief  Sink interface: push, dropping the sample if full
+   *    @param sample The sample just read
+   */
+  void addSample(const lc709203_sample_t &sample) { push(sample); }
+
+  /*!
+   *    @brief  Usable number of slots
+   *    @return Capacity, the largest power of two that fits the storage,
+   *            or 0 if there is no storage
+   */
+  lc709_ring_index_t capacity(void) const { return _buf ? _mask + 1 : 0; }
+
+private:
+  lc709203_sample_t *_buf;
+  lc709_ring_index_t _mask;
+  lc709_ring_index_t _dropped; // only the producer stores
+  lc709_ring_index_t _head; // next slot to write, only the producer stores
+  lc709_ring_index_t _tail; // next slot to read, only the consumer stores
+};
+
+#endif
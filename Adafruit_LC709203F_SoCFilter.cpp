@@ -0,0 +1,198 @@
+/*!
+ *  @file Adafruit_LC709203F_SoCFilter.cpp
+ *
+ * 	Fixed point Kalman filter fusing LC709203F readings into one smooth
+ * 	state of charge
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_SoCFilter.h"
+
+#define LC709_SOC_FULL 10000       ///< 100% in 0.01% units
+#define LC709_SOC_P_MAX 0x1000000L ///< Variance cap, sigma of about 41%
+#define LC709_SOC_Q15 32768        ///< 1.0 in Q15
+
+/*! Typical single cell LiPo open circuit voltage, 0% to 100% by 10% */
+static const uint16_t lc709_default_ocv[LC709203F_OCV_POINTS] = {
+    3000, 3450, 3600, 3680, 3740, 3790, 3840, 3900, 3970, 4070, 4200};
+
+/*!
+ *    @brief  num / den in Q15 without 64 bit math
+ *    @param num Numerator, no larger than den
+ *    @param den Denominator, not 0
+ *    @return The ratio, 0 to 32768
+ */
+static uint16_t lc709_ratio_q15(uint32_t num, uint32_t den) {
+  while (den >= 0x10000UL) {
+    num >>= 1;
+    den >>= 1;
+  }
+  return (num << 15) / den;
+}
+
+/*!
+ *    @brief  v * f in Q15 without overflow, for v up to LC709_SOC_P_MAX
+ *    @param v The value
+ *    @param f Factor in Q15, 0 to 32768
+ *    @return The product
+ */
+static uint32_t lc709_mul_q15(uint32_t v, uint16_t f) {
+  if (v < 0x10000UL)
+    return (v * f) >> 15;
+  return ((v >> 8) * f) >> 7;
+}
+
+/*!
+ *    @brief  Instantiates a filter
+ *    @param ocv_mv Open circuit voltage of the cell in mV at 0%, 10%, ...
+ *           100%, LC709203F_OCV_POINTS rising values. NULL uses a typical
+ *           LiPo curve. The array is not copied
+ */
+Adafruit_LC709203F_SoCFilter::Adafruit_LC709203F_SoCFilter(
+    const uint16_t *ocv_mv)
+    : _ocv(ocv_mv ? ocv_mv : lc709_default_ocv) {
+  setProcessNoise(1);
+  setITENoise(100);
+  setVoltageNoise(50);
+  reset();
+}
+
+/*!
+ *    @brief  How fast the true state of charge can wander between samples
+ *    @param variance_per_s Variance added per second, in (0.01%)^2. Higher
+ *           follows real changes faster, lower smooths more
+ */
+void Adafruit_LC709203F_SoCFilter::setProcessNoise(uint16_t variance_per_s) {
+  _q = variance_per_s;
+}
+
+/*!
+ *    @brief  How far an ITE reading may be off
+ *    @param sigma Standard deviation in 0.01%
+ */
+void Adafruit_LC709203F_SoCFilter::setITENoise(uint16_t sigma) {
+  _r_ite = (uint32_t)sigma * sigma;
+  if (_r_ite > LC709_SOC_P_MAX)
+    _r_ite = LC709_SOC_P_MAX;
+}
+
+/*!
+ *    @brief  How far a voltage reading may be off the OCV curve, covering
+ *            both noise and the sag under load
+ *    @param sigma_mv Standard deviation in mV
+ */
+void Adafruit_LC709203F_SoCFilter::setVoltageNoise(uint16_t sigma_mv) {
+  _sigma_mv = sigma_mv;
+}
+
+/*!
+ *    @brief  Forget the estimate; the next sample starts it over
+ */
+void Adafruit_LC709203F_SoCFilter::reset(void) {
+  _ready = false;
+  _have_ite = false;
+  _last_ms = 0;
+  _last_ite = 0;
+  _x = LC709_SOC_FULL / 2;
+  _p = LC709_SOC_P_MAX;
+}
+
+/*!
+ *    @brief  State of charge read off the OCV curve
+ *    @param mv Cell voltage
+ *    @param variance Where to store the variance of the result, from the
+ *           voltage noise and the local slope of the curve
+ *    @return State of charge in 0.01%
+ */
+uint16_t Adafruit_LC709203F_SoCFilter::voltageSoC(uint16_t mv,
+                                                  uint32_t *variance) const {
+  uint8_t i = 0;
+  while (i < LC709203F_OCV_POINTS - 2 && mv >= _ocv[i + 1])
+    i++;
+
+  uint16_t span = _ocv[i + 1] > _ocv[i] ? _ocv[i + 1] - _ocv[i] : 1;
+  int32_t soc = (int32_t)i * (LC709_SOC_FULL / 10) +
+                ((int32_t)mv - _ocv[i]) * (LC709_SOC_FULL / 10) / span;
+  if (soc < 0)
+    soc = 0;
+  if (soc > LC709_SOC_FULL)
+    soc = LC709_SOC_FULL;
+
+  uint32_t sigma = (uint32_t)_sigma_mv * (LC709_SOC_FULL / 10) / span;
+  *variance = sigma >= 4096 ? LC709_SOC_P_MAX : sigma * sigma;
+  return soc;
+}
+
+/*!
+ *    @brief  Kalman measurement update
+ *    @param z Measured state of charge
+ *    @param r Variance of the measurement
+ */
+void Adafruit_LC709203F_SoCFilter::correct(uint16_t z, uint32_t r) {
+  uint16_t k = lc709_ratio_q15(_p, _p + r);
+  int32_t x = _x + (int32_t)k * ((int32_t)z - _x) / LC709_SOC_Q15;
+  if (x < 0)
+    x = 0;
+  if (x > LC709_SOC_FULL)
+    x = LC709_SOC_FULL;
+  _x = x;
+  _p = lc709_mul_q15(_p, LC709_SOC_Q15 - k);
+  if (!_p)
+    _p = 1;
+}
+
+/*!
+ *    @brief  Predict to the sample's time from the change in ITE, then
+ *            correct with its ITE and voltage readings
+ *    @param sample The sample, in time order
+ */
+void Adafruit_LC709203F_SoCFilter::addSample(const lc709203_sample_t &sample) {
+  const lc709203_snapshot_t &d = sample.data;
+  if (!(d.valid & (LC709203F_SNAPSHOT_ITE | LC709203F_SNAPSHOT_VOLTAGE)))
+    return;
+
+  if (_ready) {
+    // ITE is coulomb counted, so its change is a good prediction of ours;
+    // a step larger than the limit is a re-estimate (e.g. initRSOC())
+    // and is left to the correction below to blend in
+    if ((d.valid & LC709203F_SNAPSHOT_ITE) && _have_ite) {
+      int32_t step = ((int32_t)d.ite - _last_ite) * 10;
+      if (step <= LC709203F_SOC_JUMP && step >= -LC709203F_SOC_JUMP) {
+        int32_t x = (int32_t)_x + step;
+        _x = x < 0 ? 0 : (x > LC709_SOC_FULL ? LC709_SOC_FULL : x);
+      }
+    }
+    uint32_t dt = sample.timestamp - _last_ms;
+    if (dt > 600000UL)
+      dt = 600000UL; // 10 minutes, keeps q * dt in range
+    _p += (uint32_t)_q * (dt / 10) / 100;
+    if (_p > LC709_SOC_P_MAX)
+      _p = LC709_SOC_P_MAX;
+  }
+  _last_ms = sample.timestamp;
+  _ready = true;
+
+  if (d.valid & LC709203F_SNAPSHOT_ITE) {
+    _last_ite = d.ite;
+    _have_ite = true;
+    correct(d.ite > 1000 ? LC709_SOC_FULL : d.ite * 10, _r_ite);
+  }
+
+  if (d.valid & LC709203F_SNAPSHOT_VOLTAGE) {
+    uint32_t r;
+    uint16_t z = voltageSoC(d.voltage, &r);
+    if (d.valid & LC709203F_SNAPSHOT_TEMPERATURE) {
+      // the curve is for room temperature; trust it less when cold,
+      // 1x at 25C growing to 5.5x at -20C
+      int16_t dc = lc709_temp_to_deci_celsius(d.temperature);
+      if (dc < 250) {
+        uint32_t f = 350 - dc;
+        if (f > 800)
+          f = 800;
+        r = r > LC709_SOC_P_MAX / 8 ? LC709_SOC_P_MAX : r * f / 100;
+      }
+    }
+    correct(z, r);
+  }
+}
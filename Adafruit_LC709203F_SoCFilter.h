@@ -0,0 +1,84 @@
+/*!
+ *  @file Adafruit_LC709203F_SoCFilter.h
+ *
+ * 	Fixed point Kalman filter fusing LC709203F readings into one smooth
+ * 	state of charge
+ *
+ * 	ITE moves in 0.1% steps and jumps after initRSOC(). The filter
+ * 	predicts the state of charge from the change in ITE between samples,
+ * 	ignoring jumps, and corrects it with two noisy measurements: ITE
+ * 	itself, and the state of charge read off an open circuit voltage
+ * 	curve. The voltage measurement is trusted less where the curve
+ * 	is flat and when the cell is cold. Everything is 32 bit integer math,
+ * 	with no loops longer than the 11 point curve, so an update takes a
+ * 	bounded number of cycles on a Cortex-M0.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_SOCFILTER_H
+#define _ADAFRUIT_LC709203F_SOCFILTER_H
+
+#include "Adafruit_LC709203F.h"
+
+#define LC709203F_OCV_POINTS 11 ///< OCV curve points, 0% to 100% by 10%
+#define LC709203F_SOC_JUMP 100  ///< Largest ITE step tracked, in 0.01%
+
+/*!
+ *    @brief  Scalar Kalman filter over ITE and voltage. State of charge and
+ *            noise figures are in 0.01% units
+ */
+class Adafruit_LC709203F_SoCFilter : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_SoCFilter(const uint16_t *ocv_mv = NULL);
+
+  void setProcessNoise(uint16_t variance_per_s);
+  void setITENoise(uint16_t sigma);
+  void setVoltageNoise(uint16_t sigma_mv);
+
+  void reset(void);
+  void addSample(const lc709203_sample_t &sample);
+
+  /*!
+   *    @brief  Filtered state of charge
+   *    @return State of charge in 0.01%, 0 to 10000
+   */
+  uint16_t soc(void) const { return _x; }
+
+  /*!
+   *    @brief  Uncertainty of soc()
+   *    @return Variance in (0.01%)^2
+   */
+  uint32_t variance(void) const { return _p; }
+
+  /*!
+   *    @brief  Has the filter seen a sample yet?
+   *    @return True once soc() holds an estimate
+   */
+  bool ready(void) const { return _ready; }
+
+#ifndef LC709203F_NO_FLOAT
+  /*!
+   *    @brief  Filtered state of charge
+   *    @return Percent, 0 to 100
+   */
+  float percent(void) const { return _x / 100.0; }
+#endif
+
+private:
+  uint16_t voltageSoC(uint16_t mv, uint32_t *variance) const;
+  void correct(uint16_t z, uint32_t r);
+
+  const uint16_t *_ocv;
+  uint16_t _q;
+  uint32_t _r_ite;
+  uint16_t _sigma_mv;
+  bool _ready;
+  bool _have_ite;
+  uint32_t _last_ms;
+  uint16_t _last_ite;
+  uint16_t _x;
+  uint32_t _p;
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*!
+ *  @file Adafruit_LC709203F_Stats.cpp
+ *
+ * 	Rolling window statistics over LC709203F samples
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Stats.h"
+
+// Readings a sample needs to be aggregated
+#define LC709_STATS_NEEDED                                                     \
+  (LC709203F_SNAPSHOT_VOLTAGE | LC709203F_SNAPSHOT_ITE |                       \
+   LC709203F_SNAPSHOT_TEMPERATURE)
+
+/*!
+ *    @brief  Instantiates an aggregator over caller supplied storage
+ *    @param storage Array of 'window' slots
+ *    @param window Number of samples to aggregate over, at least 1
+ */
+Adafruit_LC709203F_Stats::Adafruit_LC709203F_Stats(
+    lc709203_stats_slot_t *storage, uint16_t window)
+    : skipped(0), _slots(storage), _window(window ? window : 1) {
+  reset();
+}
+
+/*!
+ *    @brief  Empty the window
+ */
+void Adafruit_LC709203F_Stats::reset(void) {
+  _count = _pos = 0;
+  for (uint8_t ch = 0; ch < LC709203F_STATS_CHANNELS; ch++) {
+    _minhead[ch] = _minlen[ch] = _maxhead[ch] = _maxlen[ch] = 0;
+    _sum[ch] = 0;
+    _sumsq[ch] = 0;
+  }
+}
+
+/*!
+ *    @brief  Add a value to the min and max queues of a channel. Each queue
+ *            holds the slots that can still become the min (max), in
+ *            window order with monotonic values, so its front is the answer
+ *    @param ch The channel
+ *    @param slot Slot the value was stored in
+ *    @param v The value
+ */
+void Adafruit_LC709203F_Stats::push(uint8_t ch, uint16_t slot, uint16_t v) {
+  uint16_t i;
+
+  // drop entries the new value beats for good
+  while (_minlen[ch]) {
+    i = _minhead[ch] + _minlen[ch] - 1;
+    if (i >= _window)
+      i -= _window;
+    if (_slots[_slots[i].minq[ch]].value[ch] < v)
+      break;
+    _minlen[ch]--;
+  }
+  i = _minhead[ch] + _minlen[ch]++;
+  if (i >= _window)
+    i -= _window;
+  _slots[i].minq[ch] = slot;
+
+  while (_maxlen[ch]) {
+    i = _maxhead[ch] + _maxlen[ch] - 1;
+    if (i >= _window)
+      i -= _window;
+    if (_slots[_slots[i].maxq[ch]].value[ch] > v)
+      break;
+    _maxlen[ch]--;
+  }
+  i = _maxhead[ch] + _maxlen[ch]++;
+  if (i >= _window)
+    i -= _window;
+  _slots[i].maxq[ch] = slot;
+}
+
+/*!
+ *    @brief  Add a snapshot, evicting the oldest once the window is full
+ *    @param snap The snapshot; voltage, ITE and temperature must be valid
+ *    @return False if the snapshot was skipped for missing readings
+ */
+bool Adafruit_LC709203F_Stats::add(const lc709203_snapshot_t &snap) {
+  if ((snap.valid & LC709_STATS_NEEDED) != LC709_STATS_NEEDED) {
+    skipped++;
+    return false;
+  }
+
+  uint16_t v[LC709203F_STATS_CHANNELS];
+  v[LC709203F_STATS_VOLTAGE] = snap.voltage;
+  v[LC709203F_STATS_ITE] = snap.ite;
+  v[LC709203F_STATS_TEMPERATURE] = snap.temperature;
+
+  lc709203_stats_slot_t &s = _slots[_pos];
+  bool full = _count == _window;
+
+  for (uint8_t ch = 0; ch < LC709203F_STATS_CHANNELS; ch++) {
+    if (full) {
+      // _pos holds the oldest sample, retire it
+      uint16_t old = s.value[ch];
+      _sum[ch] -= old;
+      _sumsq[ch] -= (uint32_t)old * old;
+      if (_minlen[ch] && _slots[_minhead[ch]].minq[ch] == _pos) {
+        _minlen[ch]--;
+        if (++_minhead[ch] == _window)
+          _minhead[ch] = 0;
+      }
+      if (_maxlen[ch] && _slots[_maxhead[ch]].maxq[ch] == _pos) {
+        _maxlen[ch]--;
+        if (++_maxhead[ch] == _window)
+          _maxhead[ch] = 0;
+      }
+    }
+    s.value[ch] = v[ch];
+    _sum[ch] += v[ch];
+    _sumsq[ch] += (uint32_t)v[ch] * v[ch];
+    push(ch, _pos, v[ch]);
+  }
+
+  if (!full)
+    _count++;
+  if (++_pos == _window)
+    _pos = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Read the aggregates of one channel
+ *    @param channel Which channel
+ *    @param stats Where to store the aggregates
+ *    @return False if the window is empty or the channel is unknown
+ */
+bool Adafruit_LC709203F_Stats::get(lc709203_stats_channel_t channel,
+                                   lc709203_stats_t *stats) const {
+  if (!_count || channel >= LC709203F_STATS_CHANNELS)
+    return false;
+
+  uint8_t ch = channel;
+  stats->min = _slots[_slots[_minhead[ch]].minq[ch]].value[ch];
+  stats->max = _slots[_slots[_maxhead[ch]].maxq[ch]].value[ch];
+  stats->mean = (_sum[ch] + _count / 2) / _count;
+  // (n * sumsq - sum^2) / n^2, the exact variance rounded down. Both
+  // terms are at most (n * 65535)^2 < 2^64 for any n < 65536
+  uint64_t sum = _sum[ch];
+  uint32_t n = _count;
+  stats->variance = (n * _sumsq[ch] - sum * sum) / (n * n);
+  return true;
+}
@@ -0,0 +1,83 @@
+/*!
+ *  @file Adafruit_LC709203F_Stats.h
+ *
+ * 	Rolling window statistics over LC709203F samples
+ *
+ * 	Keeps min, max, mean and variance of voltage, ITE and temperature over
+ * 	the last N samples, using integer math only. Each sample costs O(1)
+ * 	amortized: sums are updated incrementally and min/max come from
+ * 	monotonic queues. The window is the size of the caller supplied slot
+ * 	array, e.g. 60 slots polled once a minute give hourly aggregates.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_STATS_H
+#define _ADAFRUIT_LC709203F_STATS_H
+
+#include "Adafruit_LC709203F.h"
+
+/*!  Channels tracked by Adafruit_LC709203F_Stats */
+typedef enum {
+  LC709203F_STATS_VOLTAGE,     ///< Cell voltage, mV
+  LC709203F_STATS_ITE,         ///< Indicator to empty, 0.1%
+  LC709203F_STATS_TEMPERATURE, ///< Cell temperature, 0.1K
+  LC709203F_STATS_CHANNELS,    ///< Number of channels
+} lc709203_stats_channel_t;
+
+/*!  Per sample storage for the window, one per slot */
+typedef struct {
+  uint16_t value[LC709203F_STATS_CHANNELS]; ///< Sample values
+  uint16_t minq[LC709203F_STATS_CHANNELS];  ///< Min queue entries
+  uint16_t maxq[LC709203F_STATS_CHANNELS];  ///< Max queue entries
+} lc709203_stats_slot_t;
+
+/*!  Aggregates of one channel over the window */
+typedef struct {
+  uint16_t min;      ///< Smallest value
+  uint16_t max;      ///< Largest value
+  uint16_t mean;     ///< Mean, rounded
+  uint32_t variance; ///< Population variance, units squared, rounded down
+} lc709203_stats_t;
+
+/*!
+ *    @brief  Integer rolling min/max/mean/variance aggregator
+ */
+class Adafruit_LC709203F_Stats : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_Stats(lc709203_stats_slot_t *storage, uint16_t window);
+
+  bool add(const lc709203_snapshot_t &snap);
+  void reset(void);
+  bool get(lc709203_stats_channel_t channel, lc709203_stats_t *stats) const;
+
+  /*!
+   *    @brief  Sink interface: aggregate every sample the driver reads
+   *    @param sample The sample just read
+   */
+  void addSample(const lc709203_sample_t &sample) { add(sample.data); }
+
+  /*!
+   *    @brief  Samples currently in the window
+   *    @return Count, at most the window size
+   */
+  uint16_t count(void) const { return _count; }
+
+  uint32_t skipped; ///< Samples ignored for missing readings
+
+private:
+  void push(uint8_t ch, uint16_t slot, uint16_t v);
+
+  lc709203_stats_slot_t *_slots;
+  uint16_t _window;
+  uint16_t _count;
+  uint16_t _pos; // next slot to write, the oldest once the window is full
+  uint16_t _minhead[LC709203F_STATS_CHANNELS];
+  uint16_t _minlen[LC709203F_STATS_CHANNELS];
+  uint16_t _maxhead[LC709203F_STATS_CHANNELS];
+  uint16_t _maxlen[LC709203F_STATS_CHANNELS];
+  uint32_t _sum[LC709203F_STATS_CHANNELS];
+  uint64_t _sumsq[LC709203F_STATS_CHANNELS];
+};
+
+#endif
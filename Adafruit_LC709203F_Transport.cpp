@@ -0,0 +1,146 @@
+/*!
+ *  @file Adafruit_LC709203F_Transport.cpp
+ *
+ * 	Bus transport interface for the Adafruit LC709203F driver
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Transport.h"
+
+#if !defined(ARDUINO)
+#include <chrono>
+#include <thread>
+#endif
+
+/*!
+ *    @brief  Run several write-then-reads. The default implementation runs
+ *            them one by one; backends that can issue them together (e.g.
+ *            one ioctl on Linux) override this
+ *    @param xfers The transfers, each one's 'ok' is set on return
+ *    @param count Number of transfers
+ *    @return True if every transfer completed
+ */
+bool Adafruit_LC709203F_Transport::write_then_read_batch(lc709203_xfer_t *xfers,
+                                                         size_t count) {
+  bool all = true;
+  for (size_t i = 0; i < count; i++) {
+    xfers[i].ok = write_then_read(xfers[i].write_buffer, xfers[i].write_len,
+                                  xfers[i].read_buffer, xfers[i].read_len);
+    all = all && xfers[i].ok;
+  }
+  return all;
+}
+
+/*!
+ *    @brief  Start a write-then-read. The default implementation runs the
+ *            transfer to completion here; backends with DMA or interrupt
+ *            driven I2C override this and pollTransfer()
+ *    @param write_buffer Bytes to write, must stay valid until done
+ *    @param write_len Number of bytes to write
+ *    @param read_buffer Where to store the bytes read, must stay valid
+ *    @param read_len Number of bytes to read
+ *    @return True if the transfer was started
+ */
+bool Adafruit_LC709203F_Transport::startWriteThenRead(
+    const uint8_t *write_buffer, size_t write_len, uint8_t *read_buffer,
+    size_t read_len) {
+  if (xfer_state == LC709203F_XFER_BUSY)
+    return false;
+  xfer_state = write_then_read(write_buffer, write_len, read_buffer, read_len)
+                   ? LC709203F_XFER_DONE
+                   : LC709203F_XFER_ERROR;
+  return true;
+}
+
+/*!
+ *    @brief  Check on the transfer begun with startWriteThenRead()
+ *    @return LC709203F_XFER_BUSY until the transfer ends, then DONE or ERROR
+ *            once, after which the transport is IDLE again
+ */
+lc709203_xfer_state_t Adafruit_LC709203F_Transport::pollTransfer(void) {
+  lc709203_xfer_state_t s = xfer_state;
+  if (s != LC709203F_XFER_BUSY)
+    xfer_state = LC709203F_XFER_IDLE;
+  return s;
+}
+
+/*!
+ *    @brief  Abandon the transfer begun with startWriteThenRead(), so a new
+ *            one can be started. The default just forgets it; backends
+ *            with a transfer running in hardware override this to stop it
+ */
+void Adafruit_LC709203F_Transport::cancelTransfer(void) {
+  xfer_state = LC709203F_XFER_IDLE;
+}
+
+/*!
+ *    @brief  Milliseconds since an arbitrary start point
+ *    @return Monotonic time in ms
+ */
+uint32_t Adafruit_LC709203F_Transport::nowMillis(void) {
+#if defined(ARDUINO)
+  return ::millis();
+#else
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/*!
+ *    @brief  Microseconds since an arbitrary start point, for timing
+ *            transfers
+ *    @return Monotonic time in us, wrapping every 71 minutes
+ */
+uint32_t Adafruit_LC709203F_Transport::nowMicros(void) {
+#if defined(ARDUINO)
+  return ::micros();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/*!
+ *    @brief  Busy-wait for a number of microseconds
+ *    @param us Time to wait
+ */
+void Adafruit_LC709203F_Transport::delayMicros(uint32_t us) {
+#if defined(ARDUINO)
+  while (us > 10000) {
+    ::delay(10);
+    us -= 10000;
+  }
+  ::delayMicroseconds(us);
+#else
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+#endif
+}
+
+/*!
+ *    @brief  Write bytes through the write callback
+ *    @param buffer Bytes to write
+ *    @param len Number of bytes to write
+ *    @return True if the device ACKed every byte
+ */
+bool Adafruit_LC709203F_CallbackBus::write(const uint8_t *buffer, size_t len) {
+  return _write && _write(_ctx, _addr, buffer, len);
+}
+
+/*!
+ *    @brief  Write-then-read through the write-then-read callback
+ *    @param write_buffer Bytes to write
+ *    @param write_len Number of bytes to write
+ *    @param read_buffer Where to store the bytes read
+ *    @param read_len Number of bytes to read
+ *    @return True if the transfer completed
+ */
+bool Adafruit_LC709203F_CallbackBus::write_then_read(
+    const uint8_t *write_buffer, size_t write_len, uint8_t *read_buffer,
+    size_t read_len) {
+  return _write_read &&
+         _write_read(_ctx, _addr, write_buffer, write_len, read_buffer,
+                     read_len);
+}
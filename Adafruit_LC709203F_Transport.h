@@ -0,0 +1,211 @@
+/*!
+ *  @file Adafruit_LC709203F_Transport.h
+ *
+ * 	Bus transport interface for the Adafruit LC709203F driver
+ *
+ * 	The driver only talks to the chip through this interface, so it can be
+ * 	backed by Adafruit BusIO on Arduino, or by any host-side bus (or a
+ * 	simulated one) on a plain Linux build.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_TRANSPORT_H
+#define _ADAFRUIT_LC709203F_TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include "Arduino.h"
+#include <Adafruit_I2CDevice.h>
+#endif
+
+/*!  State of an asynchronous transfer */
+typedef enum {
+  LC709203F_XFER_IDLE,  ///< No transfer started
+  LC709203F_XFER_BUSY,  ///< Transfer still in progress
+  LC709203F_XFER_DONE,  ///< Transfer finished successfully
+  LC709203F_XFER_ERROR, ///< Transfer failed (NACK or bus error)
+} lc709203_xfer_state_t;
+
+/*!  One write-then-read of a batch, see write_then_read_batch() */
+typedef struct {
+  const uint8_t *write_buffer; ///< Bytes to write
+  size_t write_len;            ///< Number of bytes to write
+  uint8_t *read_buffer;        ///< Where to store the bytes read
+  size_t read_len;             ///< Number of bytes to read
+  bool ok;                     ///< Set if this transfer completed
+} lc709203_xfer_t;
+
+/*!
+ *    @brief  Abstract I2C transport bound to one LC709203F device address
+ */
+class Adafruit_LC709203F_Transport {
+public:
+  virtual ~Adafruit_LC709203F_Transport() {}
+
+  /*!
+   *    @brief  Prepare the bus and check the device answers
+   *    @return True if the device is present
+   */
+  virtual bool begin(void) { return true; }
+
+  /*!
+   *    @brief  Write bytes to the device in one transaction
+   *    @param buffer Bytes to write
+   *    @param len Number of bytes to write
+   *    @return True if the device ACKed every byte
+   */
+  virtual bool write(const uint8_t *buffer, size_t len) = 0;
+
+  /*!
+   *    @brief  Write bytes, then read with a repeated start
+   *    @param write_buffer Bytes to write
+   *    @param write_len Number of bytes to write
+   *    @param read_buffer Where to store the bytes read
+   *    @param read_len Number of bytes to read
+   *    @return True if the transfer completed
+   */
+  virtual bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                               uint8_t *read_buffer, size_t read_len) = 0;
+
+  virtual bool write_then_read_batch(lc709203_xfer_t *xfers, size_t count);
+
+  virtual bool startWriteThenRead(const uint8_t *write_buffer,
+                                  size_t write_len, uint8_t *read_buffer,
+                                  size_t read_len);
+  virtual lc709203_xfer_state_t pollTransfer(void);
+  virtual void cancelTransfer(void);
+
+  /*!
+   *    @brief  Did the last failed transfer fail by timing out, rather than
+   *            by a NACK? Backends that can tell override this
+   *    @return True for a timeout
+   */
+  virtual bool timedOut(void) { return false; }
+
+  virtual uint32_t nowMillis(void);
+  virtual uint32_t nowMicros(void);
+  virtual void delayMicros(uint32_t us);
+
+protected:
+  lc709203_xfer_state_t xfer_state = LC709203F_XFER_IDLE; ///< Async state
+};
+
+#if defined(ARDUINO)
+/*!
+ *    @brief  Transport backed by an Adafruit BusIO I2C device, held in place
+ *            so no heap allocation is needed. It is final and its bus
+ *            methods are inline, so Adafruit_LC709203F_Driver over it calls
+ *            BusIO directly
+ */
+class Adafruit_LC709203F_BusIO final : public Adafruit_LC709203F_Transport {
+public:
+  /*!
+   *    @brief  Set up the BusIO device
+   *    @param addr The 7-bit I2C address
+   *    @param wire The Wire object to be used for I2C connections
+   */
+  Adafruit_LC709203F_BusIO(uint8_t addr, TwoWire *wire = &Wire)
+      : i2c_dev(addr, wire) {}
+
+  /*!
+   *    @brief  Move the device to another Wire bus
+   *    @param wire The Wire object to be used for I2C connections
+   */
+  void setWire(TwoWire *wire) {
+    i2c_dev = Adafruit_I2CDevice(i2c_dev.address(), wire);
+  }
+
+  /*!
+   *    @brief  Initialize the BusIO device
+   *    @return True if the device ACKs its address
+   */
+  bool begin(void) { return i2c_dev.begin(); }
+
+  /*!
+   *    @brief  Write bytes to the device in one transaction
+   *    @param buffer Bytes to write
+   *    @param len Number of bytes to write
+   *    @return True if the device ACKed every byte
+   */
+  bool write(const uint8_t *buffer, size_t len) {
+    return i2c_dev.write(buffer, len);
+  }
+
+  /*!
+   *    @brief  Write bytes, then read with a repeated start
+   *    @param write_buffer Bytes to write
+   *    @param write_len Number of bytes to write
+   *    @param read_buffer Where to store the bytes read
+   *    @param read_len Number of bytes to read
+   *    @return True if the transfer completed
+   */
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len) {
+    return i2c_dev.write_then_read(write_buffer, write_len, read_buffer,
+                                   read_len);
+  }
+
+  /*!
+   *    @brief  Run several write-then-reads one by one, as BusIO has no
+   *            batch transfer
+   *    @param xfers The transfers, each one's 'ok' is set on return
+   *    @param count Number of transfers
+   *    @return True if every transfer completed
+   */
+  bool write_then_read_batch(lc709203_xfer_t *xfers, size_t count) {
+    bool all = true;
+    for (size_t i = 0; i < count; i++) {
+      xfers[i].ok = write_then_read(xfers[i].write_buffer, xfers[i].write_len,
+                                    xfers[i].read_buffer, xfers[i].read_len);
+      all = all && xfers[i].ok;
+    }
+    return all;
+  }
+
+protected:
+  Adafruit_I2CDevice i2c_dev; ///< I2C bus interface
+};
+#endif
+
+/*! Host-side write callback, returns true on ACK */
+typedef bool (*lc709203_write_fn)(void *ctx, uint8_t addr,
+                                  const uint8_t *buffer, size_t len);
+/*! Host-side write-then-read callback, returns true on success */
+typedef bool (*lc709203_write_read_fn)(void *ctx, uint8_t addr,
+                                       const uint8_t *write_buffer,
+                                       size_t write_len, uint8_t *read_buffer,
+                                       size_t read_len);
+
+/*!
+ *    @brief  Transport that forwards to plain C callbacks, for host builds
+ *            that bring their own I2C access
+ */
+class Adafruit_LC709203F_CallbackBus : public Adafruit_LC709203F_Transport {
+public:
+  /*!
+   *    @brief  Bind the transport to a pair of callbacks
+   *    @param addr The 7-bit I2C address passed to the callbacks
+   *    @param wr Write callback
+   *    @param wrrd Write-then-read callback
+   *    @param ctx Opaque pointer passed to the callbacks
+   */
+  Adafruit_LC709203F_CallbackBus(uint8_t addr, lc709203_write_fn wr,
+                                 lc709203_write_read_fn wrrd,
+                                 void *ctx = NULL)
+      : _addr(addr), _write(wr), _write_read(wrrd), _ctx(ctx) {}
+
+  bool write(const uint8_t *buffer, size_t len);
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len);
+
+private:
+  uint8_t _addr;
+  lc709203_write_fn _write;
+  lc709203_write_read_fn _write_read;
+  void *_ctx;
+};
+
+#endif
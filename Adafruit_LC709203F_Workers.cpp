@@ -0,0 +1,205 @@
+/*!
+ *  @file Adafruit_LC709203F_Workers.cpp
+ *
+ * 	Per-bus polling threads for LC709203F gauges on Linux
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Adafruit_LC709203F_Workers.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <chrono>
+
+/*!
+ *    @brief  Instantiates the workers over caller supplied storage
+ *    @param storage Array of 'capacity' slots
+ *    @param capacity Most gauges that can be added
+ */
+Adafruit_LC709203F_Workers::Adafruit_LC709203F_Workers(
+    lc709203_worker_slot_t *storage, uint8_t capacity)
+    : _slots(storage), _capacity(capacity), _count(0), _threads(0),
+      _period_ms(0), _running(false) {
+  for (uint8_t i = 0; i < LC709203F_WORKERS_MAX_BUSES; i++)
+    _scans[i].store(0, std::memory_order_relaxed);
+}
+
+/*!
+ *    @brief  Stops the workers
+ */
+Adafruit_LC709203F_Workers::~Adafruit_LC709203F_Workers() { stop(); }
+
+/*!
+ *    @brief  Add a gauge, before start()
+ *    @param gauge The begun gauge
+ *    @param bus Number of the bus it is on; each bus gets its own thread
+ *    @return Index to read() it by, or -1 if full or running
+ */
+int16_t Adafruit_LC709203F_Workers::add(Adafruit_LC709203F_Generic *gauge,
+                                        uint8_t bus) {
+  if (_count >= _capacity || _running.load())
+    return -1;
+
+  lc709203_worker_slot_t &slot = _slots[_count];
+  slot.gauge = gauge;
+  slot.bus = bus;
+  slot.seq.store(0, std::memory_order_relaxed);
+  for (uint8_t i = 0; i < 4; i++)
+    slot.words[i].store(0, std::memory_order_relaxed);
+  return _count++;
+}
+
+/*!
+ *    @brief  Start one thread per bus
+ *    @param period_ms Time between the starts of two scans of a bus, 0 to
+ *           scan back to back
+ *    @return False if already running, or if there are more buses than
+ *            LC709203F_WORKERS_MAX_BUSES
+ */
+bool Adafruit_LC709203F_Workers::start(uint32_t period_ms) {
+  if (_running.load())
+    return false;
+
+  uint8_t buses[LC709203F_WORKERS_MAX_BUSES];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    uint8_t b = 0;
+    while (b < n && buses[b] != _slots[i].bus)
+      b++;
+    if (b == n) {
+      if (n == LC709203F_WORKERS_MAX_BUSES)
+        return false;
+      buses[n++] = _slots[i].bus;
+    }
+  }
+
+  _period_ms = period_ms;
+  _running.store(true);
+  for (_threads = 0; _threads < n; _threads++)
+    _workers[_threads] =
+        std::thread(&Adafruit_LC709203F_Workers::run, this, buses[_threads],
+                    _threads);
+  return true;
+}
+
+/*!
+ *    @brief  Stop the threads and wait for them to finish their scan
+ */
+void Adafruit_LC709203F_Workers::stop(void) {
+  _running.store(false);
+  for (uint8_t i = 0; i < _threads; i++)
+    if (_workers[i].joinable())
+      _workers[i].join();
+  _threads = 0;
+}
+
+/*!
+ *    @brief  Write a slot's sample under its sequence lock. Only the
+ *            slot's own worker writes it
+ *    @param slot The slot
+ *    @param sample The sample
+ */
+void Adafruit_LC709203F_Workers::publish(lc709203_worker_slot_t &slot,
+                                         const lc709203_sample_t &sample) {
+  uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+  slot.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const lc709203_snapshot_t &d = sample.data;
+  slot.words[0].store(sample.timestamp, std::memory_order_relaxed);
+  slot.words[1].store(d.voltage | (uint32_t)d.ite << 16,
+                      std::memory_order_relaxed);
+  slot.words[2].store(d.rsoc | (uint32_t)d.temperature << 16,
+                      std::memory_order_relaxed);
+  slot.words[3].store(d.valid, std::memory_order_relaxed);
+
+  slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+/*!
+ *    @brief  Worker loop for one bus
+ *    @param bus The bus to scan
+ *    @param worker Index of the worker, for its scan counter
+ */
+void Adafruit_LC709203F_Workers::run(uint8_t bus, uint8_t worker) {
+  std::chrono::steady_clock::time_point next =
+      std::chrono::steady_clock::now();
+
+  while (_running.load(std::memory_order_relaxed)) {
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_slots[i].bus != bus)
+        continue;
+      lc709203_sample_t sample;
+      _slots[i].gauge->readSnapshot(&sample.data);
+      sample.timestamp =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now().time_since_epoch())
+              .count();
+      publish(_slots[i], sample);
+    }
+    _scans[worker].fetch_add(1, std::memory_order_relaxed);
+
+    if (_period_ms) {
+      // sleep in short steps so stop() does not wait out a long period
+      next += std::chrono::milliseconds(_period_ms);
+      while (_running.load(std::memory_order_relaxed) &&
+             std::chrono::steady_clock::now() < next) {
+        std::chrono::steady_clock::time_point wake =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        std::this_thread::sleep_until(wake < next ? wake : next);
+      }
+    }
+  }
+}
+
+/*!
+ *    @brief  Get the latest sample of a gauge, from any thread. Never
+ *            blocks the worker; retries while the sample is being written
+ *    @param index Index returned by add()
+ *    @param sample Where to store the sample
+ *    @param generation If not NULL, where to store a count that goes up
+ *           with every new sample, to tell whether anything changed
+ *    @return False if the index is bad or nothing was published yet
+ */
+bool Adafruit_LC709203F_Workers::read(uint8_t index, lc709203_sample_t *sample,
+                                      uint32_t *generation) const {
+  if (index >= _count)
+    return false;
+
+  const lc709203_worker_slot_t &slot = _slots[index];
+  uint32_t seq, w[4];
+  do {
+    seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1)
+      continue;
+    for (uint8_t i = 0; i < 4; i++)
+      w[i] = slot.words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((seq & 1) || seq != slot.seq.load(std::memory_order_relaxed));
+
+  if (!seq)
+    return false;
+  sample->timestamp = w[0];
+  sample->data.voltage = w[1] & 0xFFFF;
+  sample->data.ite = w[1] >> 16;
+  sample->data.rsoc = w[2] & 0xFFFF;
+  sample->data.temperature = w[2] >> 16;
+  sample->data.valid = w[3];
+  if (generation)
+    *generation = seq / 2;
+  return true;
+}
+
+/*!
+ *    @brief  Scans finished by all workers together
+ *    @return Number of scans
+ */
+uint32_t Adafruit_LC709203F_Workers::scans(void) const {
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < LC709203F_WORKERS_MAX_BUSES; i++)
+    n += _scans[i].load(std::memory_order_relaxed);
+  return n;
+}
+
+#endif // __linux__ && !ARDUINO
@@ -0,0 +1,80 @@
+/*!
+ *  @file Adafruit_LC709203F_Workers.h
+ *
+ * 	Per-bus polling threads for LC709203F gauges on Linux
+ *
+ * 	Gateways with several independent I2C adapters can read them at the
+ * 	same time. Adafruit_LC709203F_Workers runs one thread per bus, each
+ * 	reading its own gauges with readSnapshot() in a loop, and publishes
+ * 	every result through a per-gauge sequence lock: readers never block
+ * 	the workers and never see a half written sample. Gauges must only be
+ * 	touched by their worker while it runs, and sample sinks added to them
+ * 	are called from that worker's thread.
+ *
+ * 	Only built on Linux host builds; link with -pthread.
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LC709203F_WORKERS_H
+#define _ADAFRUIT_LC709203F_WORKERS_H
+
+#include "Adafruit_LC709203F.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <atomic>
+#include <thread>
+
+#ifndef LC709203F_WORKERS_MAX_BUSES
+#define LC709203F_WORKERS_MAX_BUSES 8 ///< Most threads started
+#endif
+
+/*!  One gauge and its published sample, see Adafruit_LC709203F_Workers */
+typedef struct {
+  Adafruit_LC709203F_Generic *gauge; ///< The begun gauge
+  uint8_t bus;                       ///< Bus number, one thread per bus
+  std::atomic<uint32_t> seq;         ///< Odd while the sample is being written
+  std::atomic<uint32_t> words[4];    ///< The packed sample
+} lc709203_worker_slot_t;
+
+/*!
+ *    @brief  Polls gauges on several buses from one thread per bus
+ */
+class Adafruit_LC709203F_Workers {
+public:
+  Adafruit_LC709203F_Workers(lc709203_worker_slot_t *storage,
+                             uint8_t capacity);
+  ~Adafruit_LC709203F_Workers();
+
+  int16_t add(Adafruit_LC709203F_Generic *gauge, uint8_t bus);
+  bool start(uint32_t period_ms = 0);
+  void stop(void);
+
+  bool read(uint8_t index, lc709203_sample_t *sample,
+            uint32_t *generation = NULL) const;
+  uint32_t scans(void) const;
+
+  /*!
+   *    @brief  Gauges added
+   *    @return Count, valid indices for read() are below it
+   */
+  uint8_t count(void) const { return _count; }
+
+private:
+  void run(uint8_t bus, uint8_t worker);
+  void publish(lc709203_worker_slot_t &slot, const lc709203_sample_t &sample);
+
+  lc709203_worker_slot_t *_slots;
+  uint8_t _capacity;
+  uint8_t _count;
+  uint8_t _threads;
+  uint32_t _period_ms;
+  std::atomic<bool> _running;
+  std::atomic<uint32_t> _scans[LC709203F_WORKERS_MAX_BUSES];
+  std::thread _workers[LC709203F_WORKERS_MAX_BUSES];
+};
+
+#endif // __linux__ && !ARDUINO
+
+#endif
@@ -0,0 +1,45 @@
+/*!
+ *  @file Adafruit_I2CDevice.h
+ *
+ * 	Stub of the Adafruit BusIO I2C device, over the stub TwoWire
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_STUB_I2CDEVICE_H
+#define _LC709203F_STUB_I2CDEVICE_H
+
+#include "Arduino.h"
+
+/*!
+ *    @brief  Same interface as BusIO's, as far as the library uses it
+ */
+class Adafruit_I2CDevice {
+public:
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire)
+      : _addr(addr), _wire(theWire) {}
+
+  bool begin(bool addr_detect = true) {
+    return !addr_detect || _wire->transfer();
+  }
+  bool write(const uint8_t *, size_t, bool = true, const uint8_t * = NULL,
+             size_t = 0) {
+    return _wire->transfer();
+  }
+  bool read(uint8_t *buffer, size_t len, bool = true) {
+    memset(buffer, 0, len);
+    return _wire->transfer();
+  }
+  bool write_then_read(const uint8_t *, size_t, uint8_t *read_buffer,
+                       size_t read_len, bool = false) {
+    memset(read_buffer, 0, read_len);
+    return _wire->transfer();
+  }
+  uint8_t address(void) { return _addr; }
+
+private:
+  uint8_t _addr;
+  TwoWire *_wire;
+};
+
+#endif
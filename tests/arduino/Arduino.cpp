@@ -0,0 +1,51 @@
+/*!
+ *  @file Arduino.cpp
+ *
+ * 	The stub core's clock, pins and bus
+ *
+ *	BSD license (see license.txt)
+ */
+
+#include "Arduino.h"
+
+TwoWire Wire;
+uint8_t stub_pin_level[STUB_NUM_PINS];
+void (*stub_isr[STUB_NUM_PINS])(void);
+
+static unsigned long stub_us;
+
+unsigned long millis(void) { return stub_us / 1000; }
+unsigned long micros(void) { return stub_us; }
+void delay(unsigned long ms) { stub_us += ms * 1000; }
+void delayMicroseconds(unsigned int us) { stub_us += us; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < STUB_NUM_PINS && mode == INPUT_PULLUP)
+    stub_pin_level[pin] = HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < STUB_NUM_PINS ? stub_pin_level[pin] : LOW;
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+  return pin < STUB_NUM_PINS ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(uint8_t irq, void (*handler)(void), int) {
+  stub_isr[irq] = handler;
+}
+
+void detachInterrupt(uint8_t irq) { stub_isr[irq] = NULL; }
+
+/*!
+ *    @brief  Drive an input, running its handler on a falling edge
+ *    @param pin The pin
+ *    @param level LOW or HIGH
+ */
+void stub_set_pin(uint8_t pin, uint8_t level) {
+  bool falling = stub_pin_level[pin] == HIGH && level == LOW;
+  stub_pin_level[pin] = level;
+  if (falling && stub_isr[pin])
+    stub_isr[pin]();
+}
@@ -0,0 +1,45 @@
+/*!
+ *  @file Arduino.h
+ *
+ * 	Just enough of an Arduino core to build the library's ARDUINO code
+ * 	on the host: a clock that only moves when delayed, and GPIO levels and
+ * 	interrupt handlers the tests drive by hand
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_STUB_ARDUINO_H
+#define _LC709203F_STUB_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LOW 0x0
+#define HIGH 0x1
+#define FALLING 2
+#define NOT_AN_INTERRUPT -1
+#define STUB_NUM_PINS 32 ///< Pins 0..31, each its own interrupt
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t irq, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t irq);
+
+extern uint8_t stub_pin_level[STUB_NUM_PINS]; ///< Inputs read back
+extern void (*stub_isr[STUB_NUM_PINS])(void); ///< Attached handlers
+
+void stub_set_pin(uint8_t pin, uint8_t level);
+
+#include "Wire.h"
+
+#endif
@@ -0,0 +1,39 @@
+/*!
+ *  @file Wire.h
+ *
+ * 	Stub I2C bus for the host build of the ARDUINO code: every device on
+ * 	it ACKs, unless a NACK was injected, and reads return zeros
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_STUB_WIRE_H
+#define _LC709203F_STUB_WIRE_H
+
+#include <stdint.h>
+
+/*!
+ *    @brief  A bus that counts its transfers
+ */
+class TwoWire {
+public:
+  uint32_t transfers = 0; ///< Transfers addressed on this bus
+  uint8_t nack_next = 0;  ///< Transfers still to NACK
+
+  /*!
+   *    @brief  Address a device
+   *    @return True if it ACKs
+   */
+  bool transfer(void) {
+    transfers++;
+    if (nack_next) {
+      nack_next--;
+      return false;
+    }
+    return true;
+  }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,53 @@
+// Cost per byte of each CRC8 engine, against the driver's original loop
+
+#include "Adafruit_LC709203F_CRC.h"
+#include "lc709203f_test.h"
+
+#define BUF_LEN 4096
+#define ROUNDS 200
+
+static uint8_t reference_crc8(const uint8_t *data, int len) {
+  uint8_t crc = 0;
+  for (int j = len; j; --j) {
+    crc ^= *data++;
+    for (int i = 8; i; --i)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+template <uint8_t (*update)(uint8_t, uint8_t)>
+static uint8_t engine_crc8(const uint8_t *data, int len) {
+  uint8_t crc = 0;
+  while (len--)
+    crc = update(crc, *data++);
+  return crc;
+}
+
+static void run(const char *name, uint8_t (*fn)(const uint8_t *, int),
+                const uint8_t *buf) {
+  uint64_t best = ~0ULL;
+  for (int r = 0; r < ROUNDS; r++) {
+    uint64_t t0 = lc709_bench_ticks();
+    uint8_t crc = fn(buf, BUF_LEN);
+    uint64_t t = lc709_bench_ticks() - t0;
+    lc709_bench_keep(crc);
+    if (t < best)
+      best = t;
+  }
+  printf("  %-10s %6.2f %s/byte\n", name, (double)best / BUF_LEN,
+         LC709_BENCH_UNIT);
+}
+
+int main() {
+  static uint8_t buf[BUF_LEN];
+  for (int i = 0; i < BUF_LEN; i++)
+    buf[i] = (uint8_t)(i * 131 + 7);
+
+  printf("CRC8 over %d bytes, best of %d:\n", BUF_LEN, ROUNDS);
+  run("original", reference_crc8, buf);
+  run("bitwise", engine_crc8<lc709_crc8_update_bitwise>, buf);
+  run("nibble", engine_crc8<lc709_crc8_update_nibble>, buf);
+  run("table", engine_crc8<lc709_crc8_update_table>, buf);
+  return 0;
+}
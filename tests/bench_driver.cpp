@@ -0,0 +1,88 @@
+// Driver CPU time per polling read, with the bus behind a vtable
+// (Adafruit_LC709203F_Generic, as mux and i2c-dev gauges are used) and as
+// a final class (as Adafruit_LC709203F_BusIO is on Arduino). The bus
+// answers from memory, so only the driver's own work is measured
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_test.h"
+
+#define ROUNDS 100000
+
+static uint8_t reply_crc[256];
+
+// every register reads 0x0E10 (3600), with a good CRC
+class MemoryBus : public Adafruit_LC709203F_Transport {
+public:
+  bool write(const uint8_t *, size_t) { return true; }
+  bool write_then_read(const uint8_t *write_buffer, size_t,
+                       uint8_t *read_buffer, size_t) {
+    read_buffer[0] = 0x10;
+    read_buffer[1] = 0x0E;
+    read_buffer[2] = reply_crc[write_buffer[0]];
+    return true;
+  }
+  // one by one, as Adafruit_LC709203F_BusIO does
+  bool write_then_read_batch(lc709203_xfer_t *xfers, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      xfers[i].ok = write_then_read(xfers[i].write_buffer, 1,
+                                    xfers[i].read_buffer, 3);
+    return true;
+  }
+};
+
+class FinalMemoryBus final : public MemoryBus {};
+
+// hide where a pointer came from, so the compiler cannot devirtualize
+template <class T> static T *opaque(T *p) {
+  asm volatile("" : "+r"(p));
+  return p;
+}
+
+template <class Gauge> static void run(const char *name, Gauge &lc) {
+  uint64_t best_get = ~0ULL, best_snap = ~0ULL;
+  for (int r = 0; r < 20; r++) {
+    uint64_t t0 = lc709_bench_ticks();
+    for (int i = 0; i < ROUNDS; i++) {
+      uint16_t mv = 0, ite = 0, dk = 0;
+      lc.readCellVoltage(&mv);
+      lc.readCellPercent(&ite);
+      lc.readCellTemperature(&dk);
+      lc709_bench_keep(mv + ite + dk);
+    }
+    uint64_t t = lc709_bench_ticks() - t0;
+    if (t < best_get)
+      best_get = t;
+
+    t0 = lc709_bench_ticks();
+    for (int i = 0; i < ROUNDS; i++) {
+      lc709203_snapshot_t snap;
+      lc.readSnapshot(&snap);
+      lc709_bench_keep(snap);
+    }
+    t = lc709_bench_ticks() - t0;
+    if (t < best_snap)
+      best_snap = t;
+  }
+  printf("  %-18s %6.1f %s/getter, %6.1f %s/readSnapshot\n", name,
+         (double)best_get / ROUNDS / 3, LC709_BENCH_UNIT,
+         (double)best_snap / ROUNDS, LC709_BENCH_UNIT);
+}
+
+int main() {
+  const uint8_t reading[2] = {0x10, 0x0E};
+  for (int cmd = 0; cmd < 256; cmd++)
+    reply_crc[cmd] = lc709_crc8(
+        reading, 2, lc709_crc8_read_prefix(LC709203F_I2CADDR_DEFAULT, cmd));
+
+  MemoryBus bus;
+  Adafruit_LC709203F_Generic generic;
+  generic.begin(opaque<Adafruit_LC709203F_Transport>(&bus));
+  FinalMemoryBus final_bus;
+  Adafruit_LC709203F_Driver<FinalMemoryBus> direct;
+  direct.begin(&final_bus);
+
+  printf("driver CPU time, best of 20 x %d:\n", ROUNDS);
+  run("virtual bus", generic);
+  run("final bus", direct);
+  return 0;
+}
@@ -0,0 +1,43 @@
+// Host CPU cost of the float getters against the integer ones, reading
+// from the emulator, which takes no real time on the bus
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+#define ROUNDS 100000
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  lc.begin(&emu);
+
+  uint64_t t0 = lc709_bench_ticks();
+  for (int i = 0; i < ROUNDS; i++) {
+    uint16_t mv = 0, ite = 0;
+    int16_t dc = 0;
+    lc.readCellVoltage(&mv);
+    lc.readCellPercent(&ite);
+    lc.readCellTemperatureC(&dc);
+    lc709_bench_keep(mv + ite + dc);
+  }
+  uint64_t fixed = lc709_bench_ticks() - t0;
+
+#ifndef LC709203F_NO_FLOAT
+  t0 = lc709_bench_ticks();
+  for (int i = 0; i < ROUNDS; i++) {
+    float f = lc.cellVoltage() + lc.cellPercent() + lc.getCellTemperature();
+    lc709_bench_keep(f);
+  }
+  uint64_t flt = lc709_bench_ticks() - t0;
+#endif
+
+  printf("voltage + percent + temperature, per set of 3 calls:\n");
+  printf("  integer getters %7.1f %s\n", (double)fixed / ROUNDS,
+         LC709_BENCH_UNIT);
+#ifndef LC709203F_NO_FLOAT
+  printf("  float getters   %7.1f %s\n", (double)flt / ROUNDS,
+         LC709_BENCH_UNIT);
+#endif
+  return 0;
+}
@@ -0,0 +1,64 @@
+// Bus time of a fleet scan against reading the same gauges one after
+// another: 16 emulated gauges on two buses, behind one 8-channel mux each,
+// at 100 kHz
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Fleet.h"
+#include "lc709203f_mux_bus.h"
+#include "lc709203f_test.h"
+
+#define SCANS 100
+
+int main() {
+  MuxBus bus[2];
+  MuxControl ctrl0(&bus[0]), ctrl1(&bus[1]);
+  Adafruit_LC709203F_Mux mux0(&ctrl0), mux1(&ctrl1);
+  Adafruit_LC709203F_Mux *mux[2] = {&mux0, &mux1};
+  Adafruit_LC709203F_MuxChannel *ch[16];
+  Adafruit_LC709203F g[16];
+  lc709203_fleet_member_t members[16];
+  Adafruit_LC709203F_Fleet fleet(members, 16);
+
+  for (int i = 0; i < 16; i++) {
+    ch[i] = new Adafruit_LC709203F_MuxChannel(&bus[i / 8], mux[i / 8], i % 8);
+    g[i].begin(ch[i]);
+    fleet.add(&g[i], i / 8, mux[i / 8], i % 8);
+  }
+
+  lc709203_snapshot_t snaps[16];
+  uint64_t clock0[2], busy0[2];
+  uint32_t sw0[2];
+  for (int b = 0; b < 2; b++) {
+    clock0[b] = bus[b].now_us;
+    busy0[b] = bus[b].busy_us;
+    sw0[b] = mux[b]->switches;
+  }
+  uint32_t complete = 0;
+  for (int i = 0; i < SCANS; i++)
+    complete += fleet.scan(snaps);
+
+  printf("fleet scan, 16 gauges on 2 buses, per scan:\n");
+  for (int b = 0; b < 2; b++)
+    printf("  bus %d: %5.2f ms elapsed, %5.2f ms on the wires, %.1f mux "
+           "writes\n",
+           b, (bus[b].now_us - clock0[b]) / 1000.0 / SCANS,
+           (bus[b].busy_us - busy0[b]) / 1000.0 / SCANS,
+           (double)(mux[b]->switches - sw0[b]) / SCANS);
+  printf("  %u of %u snapshots complete\n", (unsigned)complete, 16 * SCANS);
+
+  // the same gauges one after another with readSnapshot(), on one bus
+  // clock: both buses' times add up
+  uint64_t t0 = bus[0].busy_us + bus[1].busy_us;
+  uint32_t sw = mux0.switches + mux1.switches;
+  for (int i = 0; i < SCANS; i++)
+    for (int k = 0; k < 16; k++)
+      g[k].readSnapshot(&snaps[k]);
+  printf("readSnapshot() one gauge at a time, per round:\n");
+  printf("  %5.2f ms on the wires, %.1f mux writes\n",
+         (bus[0].busy_us + bus[1].busy_us - t0) / 1000.0 / SCANS,
+         (double)(mux0.switches + mux1.switches - sw) / SCANS);
+
+  for (int i = 0; i < 16; i++)
+    delete ch[i];
+  return 0;
+}
@@ -0,0 +1,51 @@
+// ioctls per snapshot on the i2c-dev transport, against a userspace
+// stand-in for the adapter: batched readSnapshot(), the same four
+// registers read one by one, and readSnapshot() on a bus that NACKs 1% of
+// transfers
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_fake_i2c.h"
+#include "lc709203f_test.h"
+
+#define SNAPSHOTS 10000
+
+static void report(const char *name, const FakeAdapter &bus, uint32_t ioctls,
+                   uint32_t messages) {
+  printf("  %-28s %5.2f ioctls, %5.2f messages per snapshot\n", name,
+         (double)(bus.ioctls - ioctls) / SNAPSHOTS,
+         (double)(bus.messages - messages) / SNAPSHOTS);
+}
+
+int main() {
+  FakeAdapter bus;
+  Adafruit_LC709203F lc;
+  lc.begin(&bus);
+  lc709203_snapshot_t snap;
+
+  printf("%d snapshots:\n", SNAPSHOTS);
+  uint32_t ioctls = bus.ioctls, messages = bus.messages;
+  for (int i = 0; i < SNAPSHOTS; i++)
+    lc.readSnapshot(&snap);
+  report("readSnapshot()", bus, ioctls, messages);
+
+  ioctls = bus.ioctls;
+  messages = bus.messages;
+  for (int i = 0; i < SNAPSHOTS; i++) {
+    uint16_t v;
+    lc.readCellVoltage(&v);
+    lc.readCellPercent(&v);
+    lc.readCellTemperature(&v);
+    lc.tryCellRSOC();
+  }
+  report("four single reads", bus, ioctls, messages);
+
+  ioctls = bus.ioctls;
+  messages = bus.messages;
+  for (int i = 0; i < SNAPSHOTS; i++) {
+    if (i % 25 == 0)
+      bus.emu.injectNack(1); // 1 in 100 reads
+    lc.readSnapshot(&snap);
+  }
+  report("readSnapshot(), 1% NACKs", bus, ioctls, messages);
+  return 0;
+}
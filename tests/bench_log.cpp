@@ -0,0 +1,56 @@
+// Log size and encode cost over emulated discharge traces, against the
+// 13 bytes a raw sample takes (timestamp, four words, validity)
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Log.h"
+#include "lc709203f_test.h"
+#include <vector>
+
+static void drop_block(void *, const uint8_t *, uint16_t) {}
+
+static void trace(const char *name, uint32_t period_ms, int16_t base_ma,
+                  int16_t burst_ma, uint16_t block_size) {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  lc.begin(&emu);
+  lc.setTemperatureMode(LC709203F_TEMPERATURE_THERMISTOR);
+
+  // record the trace first, so only encoding is timed
+  std::vector<lc709203_sample_t> samples;
+  for (uint32_t i = 0; emu.getRegister(LC709203F_CMD_CELLITE) > 0; i++) {
+    emu.step(period_ms, i % 600 < 20 ? burst_ma : base_ma);
+    emu.setTemperature(2982 + (i / 120) % 30);
+    lc709203_sample_t s;
+    s.timestamp = emu.nowMillis();
+    lc.readSnapshot(&s.data);
+    samples.push_back(s);
+  }
+
+  uint8_t block[512];
+  // one untimed pass first, so page faults don't land in the short traces
+  Adafruit_LC709203F_LogEncoder warm(block, block_size, drop_block);
+  for (size_t i = 0; i < samples.size(); i++)
+    warm.add(samples[i]);
+  Adafruit_LC709203F_LogEncoder enc(block, block_size, drop_block);
+  uint64_t t0 = lc709_bench_ticks();
+  for (size_t i = 0; i < samples.size(); i++)
+    enc.add(samples[i]);
+  enc.flush();
+  uint64_t t = lc709_bench_ticks() - t0;
+
+  printf("  %-28s %6u samples, %5.2f bytes/sample (%4.1f%% of raw), "
+         "%5.1f %s/sample\n",
+         name, (unsigned)samples.size(), (double)enc.bytes / samples.size(),
+         100.0 * enc.bytes / (samples.size() * 13.0),
+         (double)t / samples.size(), LC709_BENCH_UNIT);
+}
+
+int main() {
+  printf("discharge traces, 256 byte blocks unless noted:\n");
+  trace("1 s, 200 mA + bursts", 1000, 200, 1500, 256);
+  trace("10 s, 200 mA + bursts", 10000, 200, 1500, 256);
+  trace("1 s, 50 mA steady", 1000, 50, 50, 256);
+  trace("1 s, 200 mA + bursts, 64 B", 1000, 200, 1500, 64);
+  return 0;
+}
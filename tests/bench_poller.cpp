@@ -0,0 +1,42 @@
+// Snapshots taken over a full discharge by the adaptive poller, against
+// fixed 2 s polling. The emulated 500 mAh cell is run down at 200 mA with
+// a 10 s, 1.5 A burst every ten minutes, with alarms at 3.4 V and 10%
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Poller.h"
+#include "lc709203f_test.h"
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  lc.begin(&emu);
+  lc.setAlarmMillivolts(3400);
+  lc.setAlarmRSOC(10);
+
+  Adafruit_LC709203F_Poller poller(&lc, 1000, 60000);
+  poller.setAlarmLevels(3400, 10, 30, 2);
+
+  uint32_t fixed = 0, late = 0;
+  uint32_t now = 0, burst_polls = 0;
+  while (emu.getRegister(LC709203F_CMD_CELLITE) > 0) {
+    bool burst = now % 600000 < 10000;
+    emu.step(100, burst ? 1500 : 200);
+    now += 100;
+    if (now % 2000 == 0)
+      fixed++;
+    uint32_t before = poller.polls;
+    poller.poll(now);
+    if (poller.polls != before && burst)
+      burst_polls++;
+    if ((int32_t)(now - poller.nextPoll()) > 100)
+      late++;
+  }
+
+  printf("full discharge, %u min:\n", now / 60000);
+  printf("  fixed 2 s polling     %6u snapshots\n", fixed);
+  printf("  adaptive poller       %6u snapshots (%.0f%% saved), %u during "
+         "bursts\n",
+         poller.polls, 100.0 * (fixed - poller.polls) / fixed, burst_polls);
+  return late ? 1 : 0;
+}
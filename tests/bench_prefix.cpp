@@ -0,0 +1,65 @@
+// CRC work per register read and write: the original full-message CRC,
+// the same with the table engine, and prefix state plus two data bytes
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_CRC.h"
+#include "lc709203f_test.h"
+
+#define ROUNDS 100000
+
+static const uint8_t cmds[] = {LC709203F_CMD_CELLVOLTAGE, LC709203F_CMD_CELLITE,
+                               LC709203F_CMD_RSOC,
+                               LC709203F_CMD_CELLTEMPERATURE};
+
+static uint8_t reference_crc8(const uint8_t *data, int len) {
+  uint8_t crc = 0;
+  for (int j = len; j; --j) {
+    crc ^= *data++;
+    for (int i = 8; i; --i)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+// what readWord() checked before: address, command, address|1, two bytes
+static uint8_t read_full_original(uint8_t cmd, const uint8_t *data) {
+  uint8_t msg[5] = {LC709203F_I2CADDR_DEFAULT << 1, cmd,
+                    (LC709203F_I2CADDR_DEFAULT << 1) | 1, data[0], data[1]};
+  return reference_crc8(msg, 5);
+}
+
+static uint8_t read_full_table(uint8_t cmd, const uint8_t *data) {
+  uint8_t msg[5] = {LC709203F_I2CADDR_DEFAULT << 1, cmd,
+                    (LC709203F_I2CADDR_DEFAULT << 1) | 1, data[0], data[1]};
+  return lc709_crc8(msg, 5);
+}
+
+static uint8_t read_prefix(uint8_t cmd, const uint8_t *data) {
+  return lc709_crc8(data, 2,
+                    lc709_crc8_read_prefix(LC709203F_I2CADDR_DEFAULT, cmd));
+}
+
+static void run(const char *name, uint8_t (*fn)(uint8_t, const uint8_t *)) {
+  uint8_t data[2] = {0x34, 0x12};
+  uint64_t best = ~0ULL;
+  for (int r = 0; r < 20; r++) {
+    uint64_t t0 = lc709_bench_ticks();
+    for (int i = 0; i < ROUNDS; i++) {
+      data[0] = fn(cmds[i & 3], data);
+      lc709_bench_keep(data);
+    }
+    uint64_t t = lc709_bench_ticks() - t0;
+    if (t < best)
+      best = t;
+  }
+  printf("  %-26s %6.2f %s/read\n", name, (double)best / ROUNDS,
+         LC709_BENCH_UNIT);
+}
+
+int main() {
+  printf("CRC cost per register read, best of 20 x %d:\n", ROUNDS);
+  run("5 bytes, original loop", read_full_original);
+  run("5 bytes, table engine", read_full_table);
+  run("prefix + 2 bytes", read_prefix);
+  return 0;
+}
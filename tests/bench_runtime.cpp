@@ -0,0 +1,77 @@
+// Cost of one estimator update and one estimate() call, over a recorded
+// emulator discharge, and how far the estimates land from the actual time
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Runtime.h"
+#include "lc709203f_test.h"
+#include <math.h>
+#include <vector>
+
+#ifndef LC709203F_NO_FLOAT
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  lc.begin(&emu);
+  emu.setBattery(500, 1000);
+
+  // 10 s samples at 300 mA, with 1.5 A bursts, until empty
+  std::vector<lc709203_sample_t> trace;
+  for (uint32_t i = 0; emu.getRegister(LC709203F_CMD_CELLITE); i++) {
+    emu.step(10000, i % 60 < 3 ? 1500 : 300);
+    lc709203_sample_t s;
+    s.timestamp = emu.nowMillis();
+    lc.readSnapshot(&s.data);
+    trace.push_back(s);
+  }
+  uint32_t empty = trace.back().timestamp / 1000;
+
+  Adafruit_LC709203F_Runtime rt(600);
+  uint64_t t0 = lc709_bench_ticks();
+  for (size_t i = 0; i < trace.size(); i++)
+    rt.addSample(trace[i]);
+  uint64_t update = lc709_bench_ticks() - t0;
+
+  lc709203_runtime_t est;
+  t0 = lc709_bench_ticks();
+  for (size_t i = 0; i < trace.size(); i++) {
+    rt.estimate(&est);
+    lc709_bench_keep(est);
+  }
+  uint64_t query = lc709_bench_ticks() - t0;
+
+  // accuracy once the fit has settled, replaying the trace again
+  rt.reset();
+  double err = 0, worst = 0;
+  int n = 0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    rt.addSample(trace[i]);
+    uint32_t now = trace[i].timestamp / 1000;
+    if (now < 1800 || empty - now < 600 || !rt.estimate(&est))
+      continue;
+    double e = ((double)est.seconds - (empty - now)) / (empty - now);
+    err += e * e;
+    worst = fabs(e) > worst ? fabs(e) : worst;
+    n++;
+  }
+
+  printf("%u samples, 10 s apart, 300 mA with bursts:\n",
+         (unsigned)trace.size());
+  printf("  addSample()  %6.1f %s\n", (double)update / trace.size(),
+         LC709_BENCH_UNIT);
+  printf("  estimate()   %6.1f %s\n", (double)query / trace.size(),
+         LC709_BENCH_UNIT);
+  printf("  time to empty error: %.2f%% RMS, %.2f%% worst\n",
+         100 * sqrt(err / n), 100 * worst);
+  return 0;
+}
+
+#else
+
+int main() {
+  printf("estimator not built with LC709203F_NO_FLOAT\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,53 @@
+// One readSnapshot() against the three separate integer getters, on an
+// emulated 100 kHz bus with 50 us of fixed latency per transaction. Bus
+// time is the emulator's virtual clock, CPU time is measured on the host
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+#define ROUNDS 10000
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  lc.begin(&emu);
+  emu.setLatency(50, 100000);
+
+  uint64_t bus0 = emu.virtualMicros();
+  uint32_t xfers0 = emu.transactions;
+  uint64_t t0 = lc709_bench_ticks();
+  for (int i = 0; i < ROUNDS; i++) {
+    uint16_t mv, ite, dk;
+    lc.readCellVoltage(&mv);
+    lc.readCellPercent(&ite);
+    lc.readCellTemperature(&dk);
+    lc709_bench_keep(mv + ite + dk);
+  }
+  uint64_t sep_cpu = lc709_bench_ticks() - t0;
+  uint64_t sep_bus = emu.virtualMicros() - bus0;
+  uint32_t sep_xfers = emu.transactions - xfers0;
+
+  bus0 = emu.virtualMicros();
+  xfers0 = emu.transactions;
+  t0 = lc709_bench_ticks();
+  for (int i = 0; i < ROUNDS; i++) {
+    lc709203_snapshot_t snap;
+    lc.readSnapshot(&snap);
+    lc709_bench_keep(snap);
+  }
+  uint64_t snap_cpu = lc709_bench_ticks() - t0;
+  uint64_t snap_bus = emu.virtualMicros() - bus0;
+  uint32_t snap_xfers = emu.transactions - xfers0;
+
+  printf("per call, %d calls:\n", ROUNDS);
+  printf("  3 getters (V, ITE, T):     %7.1f us bus, %u xfers, %7.1f %s\n",
+         (double)sep_bus / ROUNDS, sep_xfers / ROUNDS,
+         (double)sep_cpu / ROUNDS, LC709_BENCH_UNIT);
+  printf("  readSnapshot (+RSOC):      %7.1f us bus, %u xfers, %7.1f %s\n",
+         (double)snap_bus / ROUNDS, snap_xfers / ROUNDS,
+         (double)snap_cpu / ROUNDS, LC709_BENCH_UNIT);
+  printf("  bus time per register:     %7.1f us vs %7.1f us\n",
+         (double)sep_bus / ROUNDS / 3, (double)snap_bus / ROUNDS / 4);
+  return 0;
+}
@@ -0,0 +1,81 @@
+// State of charge filter against a simulated cell with a known true state
+// of charge: accuracy and smoothness next to raw ITE, and update cost
+
+#include "Adafruit_LC709203F_SoCFilter.h"
+#include "lc709203f_test.h"
+#include <math.h>
+#include <random>
+
+// the default OCV curve of the filter, as the simulated cell's
+static const double ocv[11] = {3000, 3450, 3600, 3680, 3740, 3790,
+                               3840, 3900, 3970, 4070, 4200};
+
+static double ocv_at(double soc) {
+  if (soc <= 0)
+    return ocv[0];
+  if (soc >= 100)
+    return ocv[10];
+  int i = soc / 10 > 9 ? 9 : (int)(soc / 10);
+  return ocv[i] + (ocv[i + 1] - ocv[i]) * (soc - i * 10) / 10;
+}
+
+#define SAMPLES 6000
+#define UPDATES 1000000
+
+int main() {
+  // a 2000 mAh cell from 95%, sampled every second, alternating 200 mA
+  // and 1200 mA every 5 minutes. ITE has 0.2% of noise and reads 3% high
+  // for 10 minutes, as after an initRSOC(); voltage has 5 mV of noise and
+  // sags 0.1 ohm under load
+  std::mt19937 gen(1);
+  std::normal_distribution<double> noise(0, 1);
+  Adafruit_LC709203F_SoCFilter filter;
+  lc709203_sample_t s;
+  s.data.valid = LC709203F_SNAPSHOT_ALL;
+  s.data.temperature = 2982;
+
+  double truth = 95, err_raw = 0, err_filt = 0, step_raw = 0, step_filt = 0;
+  double prev_raw = -1, prev_filt = -1;
+  int n = 0;
+  for (uint32_t k = 0; k < SAMPLES; k++) {
+    double ma = (k / 300) % 2 ? 1200 : 200;
+    truth -= ma / 3600 / 2000 * 100;
+    double bias = k > 3000 && k < 3600 ? 3.0 : 0.0;
+    s.timestamp = k * 1000;
+    s.data.ite = lround((truth + bias + noise(gen) * 0.2) * 10);
+    s.data.voltage = lround(ocv_at(truth) - ma * 0.1 + noise(gen) * 5);
+    filter.addSample(s);
+
+    // skip the first 200 s while the filter converges
+    if (k <= 200)
+      continue;
+    double raw = s.data.ite / 10.0, filt = filter.soc() / 100.0;
+    err_raw += (raw - truth) * (raw - truth);
+    err_filt += (filt - truth) * (filt - truth);
+    if (prev_raw >= 0) {
+      step_raw = fmax(step_raw, fabs(raw - prev_raw));
+      step_filt = fmax(step_filt, fabs(filt - prev_filt));
+    }
+    prev_raw = raw;
+    prev_filt = filt;
+    n++;
+  }
+
+  printf("simulated discharge, %d samples 1 s apart:\n", SAMPLES);
+  printf("  raw ITE   %.2f%% RMS error, largest step %.2f%%\n",
+         sqrt(err_raw / n), step_raw);
+  printf("  filtered  %.2f%% RMS error, largest step %.2f%%\n",
+         sqrt(err_filt / n), step_filt);
+
+  uint64_t t0 = lc709_bench_ticks();
+  for (uint32_t k = 0; k < UPDATES; k++) {
+    s.timestamp += 1000;
+    s.data.ite = 500 + (k & 7);
+    s.data.voltage = 3700 + (k & 15);
+    filter.addSample(s);
+  }
+  uint64_t t = lc709_bench_ticks() - t0;
+  lc709_bench_keep(filter.soc());
+  printf("  addSample() %.1f %s\n", (double)t / UPDATES, LC709_BENCH_UNIT);
+  return 0;
+}
@@ -0,0 +1,44 @@
+// Update cost per sample of the rolling aggregator, by window size. It
+// should not grow with the window
+
+#include "Adafruit_LC709203F_Stats.h"
+#include "lc709203f_test.h"
+#include <stdlib.h>
+#include <vector>
+
+#define SAMPLES 200000
+
+static void run(uint16_t window) {
+  std::vector<lc709203_stats_slot_t> slots(window);
+  Adafruit_LC709203F_Stats stats(slots.data(), window);
+
+  // a noisy discharge, so the min/max queues do real work
+  std::vector<lc709203_snapshot_t> snaps(SAMPLES);
+  srand(1);
+  for (uint32_t i = 0; i < SAMPLES; i++) {
+    snaps[i].valid = LC709203F_SNAPSHOT_ALL;
+    snaps[i].voltage = 4200 - i / 200 + rand() % 20;
+    snaps[i].ite = 1000 - i / 200;
+    snaps[i].temperature = 2982 + rand() % 5;
+  }
+
+  uint64_t t0 = lc709_bench_ticks();
+  for (uint32_t i = 0; i < SAMPLES; i++)
+    stats.add(snaps[i]);
+  uint64_t t = lc709_bench_ticks() - t0;
+
+  lc709203_stats_t s;
+  stats.get(LC709203F_STATS_VOLTAGE, &s);
+  lc709_bench_keep(s);
+  printf("  window %5u  %6.1f %s/sample\n", window, (double)t / SAMPLES,
+         LC709_BENCH_UNIT);
+}
+
+int main() {
+  printf("voltage, ITE and temperature aggregated per sample:\n");
+  run(1);
+  run(60);
+  run(1000);
+  run(65535);
+  return 0;
+}
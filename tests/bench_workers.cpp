@@ -0,0 +1,72 @@
+// Gauge reads per second with one worker thread per bus, from 1 to 8
+// buses. Each simulated bus blocks 0.3 to 0.6 ms per transfer, as a Linux
+// adapter at 100 kHz would, so the workers spend their time waiting and
+// throughput should scale with the bus count even on one core
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Workers.h"
+#include "lc709203f_test.h"
+#include <chrono>
+#include <thread>
+
+#define GAUGES_PER_BUS 2
+#define RUN_MS 1000
+
+// an emulated gauge behind a transfer that takes real time
+class SlowBus : public Adafruit_LC709203F_Emulator {
+public:
+  bool write(const uint8_t *buffer, size_t len) {
+    wait();
+    return Adafruit_LC709203F_Emulator::write(buffer, len);
+  }
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len) {
+    wait();
+    return Adafruit_LC709203F_Emulator::write_then_read(
+        write_buffer, write_len, read_buffer, read_len);
+  }
+
+private:
+  void wait(void) {
+    uint32_t us = 300 + (_n++ % 4) * 100;
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  }
+  uint32_t _n = 0;
+};
+
+static void run(uint8_t buses) {
+  static SlowBus bus[8 * GAUGES_PER_BUS];
+  static Adafruit_LC709203F gauge[8 * GAUGES_PER_BUS];
+  static lc709203_worker_slot_t slots[8 * GAUGES_PER_BUS];
+  Adafruit_LC709203F_Workers workers(slots, 8 * GAUGES_PER_BUS);
+
+  uint8_t n = buses * GAUGES_PER_BUS;
+  for (uint8_t i = 0; i < n; i++) {
+    gauge[i].begin(&bus[i]);
+    workers.add(&gauge[i], i % buses);
+  }
+
+  workers.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+  workers.stop();
+
+  uint32_t reads = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    lc709203_sample_t s;
+    uint32_t gen = 0;
+    workers.read(i, &s, &gen);
+    reads += gen;
+  }
+  printf("  %u bus%s  %5.0f gauge reads/s\n", buses, buses > 1 ? "es" : "  ",
+         reads * 1000.0 / RUN_MS);
+}
+
+int main() {
+  printf("%d gauges per bus, 0.3-0.6 ms per transfer:\n", GAUGES_PER_BUS);
+  run(1);
+  run(2);
+  run(4);
+  run(8);
+  return 0;
+}
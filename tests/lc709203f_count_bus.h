@@ -0,0 +1,69 @@
+/*!
+ *  @file lc709203f_count_bus.h
+ *
+ * 	An emulated gauge that counts the register reads and writes it sees,
+ * 	for the cache and configuration tests
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_COUNT_BUS_H
+#define _LC709203F_COUNT_BUS_H
+
+#include "Adafruit_LC709203F_Emulator.h"
+#include <string.h>
+
+/*!
+ *    @brief  Emulator that counts transfers per register
+ */
+class CountBus : public Adafruit_LC709203F_Emulator {
+public:
+  uint16_t reads[256];  ///< Read transfers per command
+  uint16_t writes[256]; ///< Write transfers per command
+
+  CountBus() { clear(); }
+
+  /*!
+   *    @brief  Zero the counts
+   */
+  void clear(void) {
+    memset(reads, 0, sizeof(reads));
+    memset(writes, 0, sizeof(writes));
+  }
+
+  /*!
+   *    @brief  All read transfers seen
+   *    @return Sum of reads[]
+   */
+  uint32_t totalReads(void) const { return sum(reads); }
+
+  /*!
+   *    @brief  All write transfers seen
+   *    @return Sum of writes[]
+   */
+  uint32_t totalWrites(void) const { return sum(writes); }
+
+  bool write(const uint8_t *buffer, size_t len) {
+    if (len)
+      writes[buffer[0]]++;
+    return Adafruit_LC709203F_Emulator::write(buffer, len);
+  }
+
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len) {
+    if (write_len)
+      reads[write_buffer[0]]++;
+    return Adafruit_LC709203F_Emulator::write_then_read(
+        write_buffer, write_len, read_buffer, read_len);
+  }
+
+private:
+  static uint32_t sum(const uint16_t *counts) {
+    uint32_t n = 0;
+    for (int i = 0; i < 256; i++)
+      n += counts[i];
+    return n;
+  }
+};
+
+#endif
@@ -0,0 +1,65 @@
+/*!
+ *  @file lc709203f_fake_i2c.h
+ *
+ * 	A userspace stand-in for a Linux i2c-dev adapter: the LinuxI2C
+ * 	transport with its ioctl replaced by an emulated gauge, counting the
+ * 	ioctls and messages it is handed
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_FAKE_I2C_H
+#define _LC709203F_FAKE_I2C_H
+
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_LinuxI2C.h"
+
+/*!
+ *    @brief  LinuxI2C over an emulator at 0x0B instead of /dev/i2c-N
+ */
+class FakeAdapter : public Adafruit_LC709203F_LinuxI2C {
+public:
+  Adafruit_LC709203F_Emulator emu; ///< The gauge on the adapter
+  uint32_t ioctls = 0;             ///< I2C_RDWR calls made
+  uint32_t messages = 0;           ///< i2c_msg structs in them
+  bool time_out = false;           ///< Fail every call with ETIMEDOUT
+
+  FakeAdapter() : Adafruit_LC709203F_LinuxI2C("/dev/i2c-fake") {}
+
+  // there is no device node to open
+  bool begin(void) { return true; }
+
+protected:
+  // runs the messages in order, joining a write and the read after it
+  // into one repeated start transfer. Like the kernel, the call fails as a
+  // whole at the first NACK, after the messages before it went out
+  bool transfer(struct i2c_msg *msgs, size_t count) {
+    ioctls++;
+    messages += count;
+    if (time_out) {
+      timed_out = true;
+      return false;
+    }
+    timed_out = false;
+    for (size_t i = 0; i < count; i++) {
+      bool ok;
+      if (msgs[i].addr != LC709203F_I2CADDR_DEFAULT)
+        ok = false;
+      else if (i + 1 < count && !(msgs[i].flags & I2C_M_RD) &&
+               (msgs[i + 1].flags & I2C_M_RD)) {
+        ok = emu.write_then_read(msgs[i].buf, msgs[i].len, msgs[i + 1].buf,
+                                 msgs[i + 1].len);
+        i++;
+      } else if (!(msgs[i].flags & I2C_M_RD)) {
+        ok = emu.write(msgs[i].buf, msgs[i].len);
+      } else {
+        ok = false; // a bare read, the driver never sends one
+      }
+      if (!ok)
+        return false;
+    }
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,131 @@
+/*!
+ *  @file lc709203f_mux_bus.h
+ *
+ * 	An emulated I2C bus with a TCA9548A style mux and one emulated gauge
+ * 	per channel, for the fleet test and benchmark. Every gauge answers at
+ * 	0x0B, so transfers go to whichever channel the mux has selected, and
+ * 	all of them share the bus's virtual clock
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_MUX_BUS_H
+#define _LC709203F_MUX_BUS_H
+
+#include "Adafruit_LC709203F_Emulator.h"
+
+/*!
+ *    @brief  Transport to 0x0B on the bus, routed through the mux
+ */
+class MuxBus : public Adafruit_LC709203F_Transport {
+public:
+  Adafruit_LC709203F_Emulator gauge[8]; ///< One gauge per channel
+  uint8_t selected = 0;                 ///< Mux control register
+  uint64_t now_us = 0;                  ///< The bus clock
+  uint64_t busy_us = 0;                 ///< Time the wires were in use
+  uint32_t poll_us = 10;                ///< Clock cost of a pollTransfer()
+
+  bool write(const uint8_t *buffer, size_t len) {
+    Adafruit_LC709203F_Emulator *g = target();
+    return g && charge(g, g->write(buffer, len));
+  }
+
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len) {
+    Adafruit_LC709203F_Emulator *g = target();
+    return g && charge(g, g->write_then_read(write_buffer, write_len,
+                                             read_buffer, read_len));
+  }
+
+  // runs the transfer now, then rewinds the clock so it appears to end
+  // once enough polls have passed
+  bool startWriteThenRead(const uint8_t *write_buffer, size_t write_len,
+                          uint8_t *read_buffer, size_t read_len) {
+    if (xfer_state == LC709203F_XFER_BUSY)
+      return false;
+    uint64_t start = now_us;
+    _ok = write_then_read(write_buffer, write_len, read_buffer, read_len);
+    _done_us = now_us;
+    now_us = start;
+    xfer_state = LC709203F_XFER_BUSY;
+    return true;
+  }
+
+  lc709203_xfer_state_t pollTransfer(void) {
+    if (xfer_state == LC709203F_XFER_BUSY) {
+      now_us += poll_us;
+      if (now_us >= _done_us)
+        xfer_state = _ok ? LC709203F_XFER_DONE : LC709203F_XFER_ERROR;
+    }
+    return Adafruit_LC709203F_Transport::pollTransfer();
+  }
+
+  uint32_t nowMillis(void) { return now_us / 1000; }
+  uint32_t nowMicros(void) { return now_us; }
+  void delayMicros(uint32_t us) { now_us += us; }
+
+  /*!
+   *    @brief  Account for a mux control write on this bus
+   *    @param mask The new control register
+   */
+  void muxWrite(uint8_t mask) {
+    selected = mask;
+    // address + 1 byte at 100 kHz
+    now_us += 200;
+    busy_us += 200;
+  }
+
+private:
+  // the single selected gauge, NACK (NULL) for none or several
+  Adafruit_LC709203F_Emulator *target(void) {
+    if (!selected || (selected & (selected - 1)))
+      return NULL;
+    uint8_t ch = 0;
+    while (!(selected & (1 << ch)))
+      ch++;
+    return &gauge[ch];
+  }
+
+  bool charge(Adafruit_LC709203F_Emulator *g, bool ok) {
+    // the gauge's own clock moved by the transfer time, copy that over
+    uint64_t t = g->virtualMicros() - _seen[g - gauge];
+    _seen[g - gauge] = g->virtualMicros();
+    now_us += t;
+    busy_us += t;
+    return ok;
+  }
+
+  uint64_t _seen[8] = {0};
+  uint64_t _done_us = 0;
+  bool _ok = false;
+};
+
+/*!
+ *    @brief  Transport to the mux's own address on a MuxBus
+ */
+class MuxControl : public Adafruit_LC709203F_Transport {
+public:
+  /*!
+   *    @brief  Bind to a bus
+   *    @param bus The bus the mux is on
+   */
+  explicit MuxControl(MuxBus *bus) : _bus(bus) {}
+
+  bool write(const uint8_t *buffer, size_t len) {
+    if (len != 1)
+      return false;
+    _bus->muxWrite(buffer[0]);
+    return true;
+  }
+
+  bool write_then_read(const uint8_t *, size_t, uint8_t *, size_t) {
+    return false;
+  }
+
+  uint32_t nowMicros(void) { return _bus->nowMicros(); }
+
+private:
+  MuxBus *_bus;
+};
+
+#endif
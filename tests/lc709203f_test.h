@@ -0,0 +1,81 @@
+/*!
+ *  @file lc709203f_test.h
+ *
+ * 	Check macros and a cycle counter shared by the host tests and
+ * 	benchmarks. A test exits non-zero if any check failed
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _LC709203F_TEST_H
+#define _LC709203F_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static int lc709_test_failures; ///< Checks failed so far
+
+/*! Record a failure unless 'cond' holds */
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      lc709_test_failures++;                                                   \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,         \
+              #cond);                                                          \
+    }                                                                          \
+  } while (0)
+
+/*! Record a failure unless 'a' == 'b', printing both */
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long _a = (long long)(a), _b = (long long)(b);                        \
+    if (_a != _b) {                                                            \
+      lc709_test_failures++;                                                   \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n",        \
+              __FILE__, __LINE__, #a, #b, _a, _b);                             \
+    }                                                                          \
+  } while (0)
+
+/*!
+ *    @brief  Report the result, for returning from main()
+ *    @return Process exit code
+ */
+static inline int lc709_test_done(void) {
+  printf("%s\n", lc709_test_failures ? "FAILED" : "ok");
+  return lc709_test_failures ? 1 : 0;
+}
+
+/*!
+ *    @brief  A fine grained timestamp for benchmarks
+ *    @return TSC cycles on x86, nanoseconds elsewhere
+ */
+static inline uint64_t lc709_bench_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+/*! Unit of lc709_bench_ticks() */
+#if defined(__x86_64__) || defined(__i386__)
+#define LC709_BENCH_UNIT "cycles"
+#else
+#define LC709_BENCH_UNIT "ns"
+#endif
+
+/*!
+ *    @brief  Keep the optimizer from discarding a benchmarked result
+ *    @param value The result
+ */
+template <typename T> static inline void lc709_bench_keep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif
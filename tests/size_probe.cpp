@@ -0,0 +1,47 @@
+// Smallest program reading voltage, state and temperature, for measuring
+// what the float API costs in flash. Built by 'make -C tests size' once
+// with the float getters and once with LC709203F_NO_FLOAT and the integer
+// getters, both through the virtual transport; then once more with the
+// float getters and LC709203F_PROBE_FINAL, which instantiates the driver
+// over a final bus, as Adafruit_LC709203F is over BusIO on Arduino
+
+#include "Adafruit_LC709203F.h"
+
+// a transport that answers nothing, so no emulator code is linked in
+#ifdef LC709203F_PROBE_FINAL
+class NullBus final : public Adafruit_LC709203F_Transport {
+#else
+class NullBus : public Adafruit_LC709203F_Transport {
+#endif
+public:
+  bool write(const uint8_t *, size_t) { return true; }
+  bool write_then_read(const uint8_t *, size_t, uint8_t *read_buffer,
+                       size_t read_len) {
+    for (size_t i = 0; i < read_len; i++)
+      read_buffer[i] = 0;
+    return true;
+  }
+};
+
+volatile uint32_t sink;
+
+int main() {
+  NullBus bus;
+#ifdef LC709203F_PROBE_FINAL
+  Adafruit_LC709203F_Driver<NullBus> lc;
+#else
+  Adafruit_LC709203F lc;
+#endif
+  lc.begin(&bus);
+#ifdef LC709203F_NO_FLOAT
+  uint16_t mv, ite;
+  int16_t dc;
+  lc.readCellVoltage(&mv);
+  lc.readCellPercent(&ite);
+  lc.readCellTemperatureC(&dc);
+  sink = mv + ite + dc;
+#else
+  sink = lc.cellVoltage() + lc.cellPercent() + lc.getCellTemperature();
+#endif
+  return 0;
+}
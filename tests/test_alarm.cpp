@@ -0,0 +1,87 @@
+// ALARMB handling: the emulator's alarmLine() stands in for the GPIO, its
+// falling edges are fed to alarmEdge(), and serviceAlarm() must debounce
+// them and report which threshold fired
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+static uint8_t fired_bits;
+static int fired_calls;
+
+static void on_alarm(uint8_t alarms) {
+  fired_bits |= alarms;
+  fired_calls++;
+}
+
+// run the battery for 'ms', watching the line like a falling edge IRQ
+static void run(Adafruit_LC709203F &lc, Adafruit_LC709203F_Emulator &emu,
+                bool *line, uint32_t ms, int16_t load_ma) {
+  for (uint32_t t = 0; t < ms; t++) {
+    emu.step(1, load_ma);
+    bool now = emu.alarmLine();
+    if (*line && !now)
+      lc.alarmEdge();
+    *line = now;
+    lc.serviceAlarm();
+  }
+}
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  lc.onAlarm(on_alarm, 20);
+  emu.setBattery(100, 105); // 10.5%
+
+  CHECK(lc.setAlarmRSOC(10));
+  CHECK(lc.setAlarmMillivolts(0));
+  bool line = emu.alarmLine();
+  CHECK(line); // not asserted yet
+
+  // nothing pending, nothing on the bus
+  uint32_t xfers = emu.transactions;
+  CHECK_EQ(lc.serviceAlarm(), 0);
+  CHECK_EQ(emu.transactions, xfers);
+
+  // 100 mAh at 360 mA: 0.1% per second, RSOC reaches 10% within ~1 s
+  run(lc, emu, &line, 3000, 360);
+  CHECK(!line);
+  CHECK_EQ(fired_calls, 1);
+  CHECK_EQ(fired_bits, LC709203F_ALARM_RSOC);
+
+  // the debounce holds the callback back for 20 ms after the edge
+  fired_calls = 0;
+  fired_bits = 0;
+  lc.alarmEdge();
+  CHECK_EQ(lc.serviceAlarm(), 0);
+  emu.advance(19000);
+  CHECK_EQ(lc.serviceAlarm(), 0);
+  CHECK_EQ(fired_calls, 0);
+  emu.advance(1000);
+  CHECK_EQ(lc.serviceAlarm(), LC709203F_ALARM_RSOC);
+  CHECK_EQ(fired_calls, 1);
+
+  // an edge with no threshold crossed (a glitch) dispatches nothing
+  CHECK(lc.setAlarmRSOC(0));
+  fired_calls = 0;
+  lc.alarmEdge();
+  emu.advance(25000);
+  CHECK_EQ(lc.serviceAlarm(), 0);
+  CHECK_EQ(fired_calls, 0);
+
+  // voltage alarm: recharge, then discharge through the threshold
+  emu.setBattery(100, 400);
+  line = emu.alarmLine();
+  CHECK(lc.setAlarmMillivolts(3700));
+  CHECK(line);
+  fired_bits = 0;
+  fired_calls = 0;
+  run(lc, emu, &line, 60000, 360);
+  CHECK(!line);
+  CHECK_EQ(fired_calls, 1);
+  CHECK_EQ(fired_bits, LC709203F_ALARM_VOLTAGE);
+  CHECK(emu.getRegister(LC709203F_CMD_CELLVOLTAGE) < 3700);
+
+  return lc709_test_done();
+}
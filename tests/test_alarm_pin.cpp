@@ -0,0 +1,62 @@
+// attachAlarm() on the stub core: the ALARMB interrupt reaches the gauge
+// that attached it, a second gauge cannot take the pin trampoline over,
+// and detaching (or destroying) the owner frees it
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_test.h"
+
+static void on_alarm(uint8_t) {}
+
+// true if an edge on 'pin' left 'lc' with an alarm to service: after the
+// debounce, serviceAlarm() goes to the bus to find out which one fired
+static bool edge_reaches(Adafruit_LC709203F &lc, uint8_t pin) {
+  stub_set_pin(pin, LOW);
+  lc.serviceAlarm();
+  delay(20);
+  uint32_t before = Wire.transfers;
+  lc.serviceAlarm();
+  stub_set_pin(pin, HIGH);
+  return Wire.transfers != before;
+}
+
+int main() {
+  Adafruit_LC709203F a, b;
+  CHECK(a.begin(&Wire));
+  CHECK(b.begin(&Wire));
+
+  CHECK(!a.attachAlarm(STUB_NUM_PINS, on_alarm)); // no interrupt
+  CHECK(a.attachAlarm(5, on_alarm));
+  CHECK(stub_isr[5] != NULL);
+  CHECK(edge_reaches(a, 5));
+
+  // a second gauge is refused, and the first keeps its alarms
+  CHECK(!b.attachAlarm(6, on_alarm));
+  CHECK(stub_isr[6] == NULL);
+  CHECK(edge_reaches(a, 5));
+  CHECK(!edge_reaches(b, 5));
+
+  // the owner may move to another pin
+  CHECK(a.attachAlarm(7, on_alarm));
+  CHECK(stub_isr[5] == NULL);
+  CHECK(edge_reaches(a, 7));
+
+  // once it lets go, the other gauge can attach
+  a.detachAlarm();
+  CHECK(stub_isr[7] == NULL);
+  CHECK(b.attachAlarm(6, on_alarm));
+  CHECK(edge_reaches(b, 6));
+  CHECK(!edge_reaches(a, 6));
+  b.detachAlarm();
+
+  // an attached gauge going out of scope lets go too
+  {
+    Adafruit_LC709203F c;
+    CHECK(c.begin(&Wire));
+    CHECK(c.attachAlarm(8, on_alarm));
+    CHECK(!a.attachAlarm(9, on_alarm));
+  }
+  CHECK(stub_isr[8] == NULL);
+  CHECK(a.attachAlarm(9, on_alarm));
+
+  return lc709_test_done();
+}
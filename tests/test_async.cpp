@@ -0,0 +1,77 @@
+// The startRead()/pollRead() state machine against an emulator whose
+// transfers take virtual time to complete
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+// poll until the read settles, advancing virtual time between polls
+static lc709203_xfer_state_t finish(Adafruit_LC709203F &lc,
+                                    Adafruit_LC709203F_Emulator &emu,
+                                    uint16_t *data, int *polls) {
+  lc709203_xfer_state_t st;
+  *polls = 0;
+  while ((st = lc.pollRead(data)) == LC709203F_XFER_BUSY && *polls < 10000) {
+    (*polls)++;
+    emu.advance(50);
+  }
+  return st;
+}
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  emu.setLatency(200, 100000);
+
+  uint16_t v = 0;
+  int polls;
+  CHECK_EQ(lc.pollRead(&v), LC709203F_XFER_IDLE);
+
+  // 200 us latency + 6 bytes at 100 kHz: several polls before the reply
+  uint64_t t0 = emu.virtualMicros();
+  CHECK(lc.startRead(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(emu.virtualMicros(), t0); // starting does not block
+  CHECK(!lc.startRead(LC709203F_CMD_CELLITE)); // one read at a time
+  CHECK_EQ(finish(lc, emu, &v, &polls), LC709203F_XFER_DONE);
+  CHECK(polls >= 10);
+  CHECK(emu.virtualMicros() - t0 >= 200 + 560);
+  CHECK_EQ(v, emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(lc.pollRead(&v), LC709203F_XFER_IDLE);
+
+  emu.injectCRCError(1);
+  CHECK(lc.startRead(LC709203F_CMD_CELLITE));
+  CHECK_EQ(finish(lc, emu, &v, &polls), LC709203F_XFER_ERROR);
+
+  emu.injectNack(1);
+  CHECK(lc.startRead(LC709203F_CMD_CELLITE));
+  CHECK_EQ(finish(lc, emu, &v, &polls), LC709203F_XFER_ERROR);
+
+  // the state machine recovers after errors
+  CHECK(lc.startRead(LC709203F_CMD_CELLITE));
+  CHECK_EQ(finish(lc, emu, &v, &polls), LC709203F_XFER_DONE);
+  CHECK_EQ(v, emu.getRegister(LC709203F_CMD_CELLITE));
+
+  // two gauges on separate buses overlap their reads
+  Adafruit_LC709203F_Emulator emu2;
+  Adafruit_LC709203F lc2;
+  CHECK(lc2.begin(&emu2));
+  emu2.setLatency(200, 100000);
+  emu2.setBattery(500, 250);
+  uint16_t a = 0, b = 0;
+  CHECK(lc.startRead(LC709203F_CMD_CELLITE));
+  CHECK(lc2.startRead(LC709203F_CMD_CELLITE));
+  lc709203_xfer_state_t sa, sb;
+  int steps = 0;
+  do {
+    sa = lc.pollRead(&a);
+    sb = lc2.pollRead(&b);
+    emu.advance(50);
+    emu2.advance(50);
+  } while ((sa == LC709203F_XFER_BUSY || sb == LC709203F_XFER_BUSY) &&
+           ++steps < 10000);
+  CHECK_EQ(a, emu.getRegister(LC709203F_CMD_CELLITE));
+  CHECK_EQ(b, 250);
+
+  return lc709_test_done();
+}
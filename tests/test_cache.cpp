@@ -0,0 +1,98 @@
+// The configuration shadow cache: getters served from RAM once a register
+// is known, live registers always read from the chip, and a failed write
+// forgetting what it may or may not have changed
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_count_bus.h"
+#include "lc709203f_test.h"
+
+int main() {
+  CountBus emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+
+  // off by default: every getter is a bus read
+  emu.clear();
+  CHECK_EQ(lc.getThermistorB(), lc.getThermistorB());
+  CHECK_EQ(emu.reads[LC709203F_CMD_THERMISTORB], 2);
+
+  // registers begin() wrote, or a getter read, are known
+  lc.enableCache();
+  emu.clear();
+  CHECK_EQ(lc.getPackAPA(), LC709203F_APA_500MAH);
+  CHECK_EQ(lc.getBattProfile(), 1);
+  CHECK_EQ(lc.getTemperatureMode(), LC709203F_TEMPERATURE_THERMISTOR);
+  CHECK_EQ(lc.getThermistorB(), emu.getRegister(LC709203F_CMD_THERMISTORB));
+  CHECK_EQ(emu.totalReads(), 0);
+
+  // the first read of an unknown one goes to the chip, later ones do not
+  CHECK_EQ(lc.getICversion(), 0x2717);
+  CHECK_EQ(lc.getICversion(), 0x2717);
+  CHECK_EQ(emu.reads[LC709203F_CMD_ICVERSION], 1);
+
+  // live registers always go to the chip
+  emu.clear();
+  uint16_t v;
+  for (int i = 0; i < 3; i++) {
+    emu.step(1000, 500);
+    CHECK(lc.readCellVoltage(&v));
+    CHECK_EQ(v, emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+    CHECK(lc.readCellPercent(&v));
+    CHECK(lc.readCellTemperature(&v));
+    CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+  }
+  CHECK_EQ(emu.reads[LC709203F_CMD_CELLVOLTAGE], 3);
+  CHECK_EQ(emu.reads[LC709203F_CMD_CELLITE], 3);
+  CHECK_EQ(emu.reads[LC709203F_CMD_CELLTEMPERATURE], 3);
+  CHECK_EQ(emu.reads[LC709203F_CMD_RSOC], 3);
+  CHECK_EQ(emu.totalReads(), 12);
+
+  // a write updates the shadow
+  CHECK(lc.setThermistorB(3950));
+  emu.clear();
+  CHECK_EQ(lc.getThermistorB(), 3950);
+  CHECK_EQ(emu.totalReads(), 0);
+
+  // a failed write drops it, so the getter asks the chip again
+  emu.injectNack(1);
+  CHECK(!lc.setThermistorB(4000));
+  CHECK_EQ(lc.getThermistorB(), 3950);
+  CHECK_EQ(emu.reads[LC709203F_CMD_THERMISTORB], 1);
+  CHECK_EQ(lc.getThermistorB(), 3950);
+  CHECK_EQ(emu.reads[LC709203F_CMD_THERMISTORB], 1);
+
+  // a change behind the driver's back shows after refreshCache(), which
+  // reads every shadowed register once
+  emu.setRegister(LC709203F_CMD_APA, LC709203F_APA_2000MAH);
+  CHECK_EQ(lc.getPackAPA(), LC709203F_APA_500MAH);
+  emu.clear();
+  CHECK(lc.refreshCache());
+  CHECK_EQ(emu.totalReads(), LC709203F_SHADOW_REGS);
+  CHECK_EQ(lc.getPackAPA(), LC709203F_APA_2000MAH);
+  CHECK_EQ(emu.totalReads(), LC709203F_SHADOW_REGS);
+
+  // as does invalidateCache(), one register at a time
+  emu.setRegister(LC709203F_CMD_APA, LC709203F_APA_100MAH);
+  lc.invalidateCache();
+  emu.clear();
+  CHECK_EQ(lc.getPackAPA(), LC709203F_APA_100MAH);
+  CHECK_EQ(lc.getPackAPA(), LC709203F_APA_100MAH);
+  CHECK_EQ(emu.totalReads(), 1);
+
+  // a failed refresh leaves the unread registers unknown
+  emu.injectNack(1);
+  CHECK(!lc.refreshCache());
+  emu.clear();
+  lc.getThermistorB();
+  lc.getPackAPA();
+  CHECK_EQ(emu.reads[LC709203F_CMD_THERMISTORB], 1);
+  CHECK_EQ(emu.reads[LC709203F_CMD_APA], 0);
+
+  // turned off, getters read the chip again
+  lc.enableCache(false);
+  emu.clear();
+  lc.getPackAPA();
+  CHECK_EQ(emu.reads[LC709203F_CMD_APA], 1);
+
+  return lc709_test_done();
+}
@@ -0,0 +1,101 @@
+// Staged configuration: begin() writes each register once, diffConfig()
+// finds the fields that differ from the known chip state, and
+// applyConfig() writes only those
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_count_bus.h"
+#include "lc709203f_test.h"
+
+// the register behind each LC709203F_CONFIG_* bit
+static const uint8_t config_cmds[7] = {
+    LC709203F_CMD_POWERMODE,   LC709203F_CMD_APA,
+    LC709203F_CMD_BATTPROF,    LC709203F_CMD_STATUSBIT,
+    LC709203F_CMD_THERMISTORB, LC709203F_CMD_ALARMRSOC,
+    LC709203F_CMD_ALARMVOLT};
+
+// exactly one write to each register in 'fields', none to any other
+static void check_written_once(const CountBus &emu, uint8_t fields) {
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < 7; i++) {
+    CHECK_EQ(emu.writes[config_cmds[i]], (fields >> i) & 1);
+    n += (fields >> i) & 1;
+  }
+  CHECK_EQ(emu.totalWrites(), n);
+}
+
+int main() {
+  // the defaults: four registers, one write each
+  {
+    CountBus emu;
+    Adafruit_LC709203F lc;
+    CHECK(lc.begin(&emu));
+    check_written_once(emu, LC709203F_CONFIG_POWERMODE | LC709203F_CONFIG_APA |
+                                LC709203F_CONFIG_BATTPROF |
+                                LC709203F_CONFIG_TEMPMODE);
+    CHECK_EQ(emu.getRegister(LC709203F_CMD_APA), LC709203F_APA_500MAH);
+    CHECK_EQ(emu.getRegister(LC709203F_CMD_BATTPROF), 1);
+  }
+
+  // the defaults overridden before begin(): still one write each, with
+  // the staged values
+  CountBus emu;
+  Adafruit_LC709203F lc;
+  lc709203_config_t cfg;
+  Adafruit_LC709203F::defaultConfig(&cfg);
+  cfg.apa = LC709203F_APA_2000MAH;
+  cfg.thermistor_b = 3950;
+  cfg.alarm_rsoc = 10;
+  cfg.alarm_voltage = 3300;
+  cfg.fields |= LC709203F_CONFIG_THERMISTORB | LC709203F_CONFIG_ALARMRSOC |
+                LC709203F_CONFIG_ALARMVOLT;
+  CHECK(lc.begin(&emu, &cfg));
+  check_written_once(emu, cfg.fields);
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_APA), LC709203F_APA_2000MAH);
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_THERMISTORB), 3950);
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_ALARMRSOC), 10);
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_ALARMVOLT), 3300);
+
+  // nothing changed, nothing to write
+  CHECK_EQ(lc.diffConfig(&cfg), 0);
+  emu.clear();
+  CHECK(lc.applyConfig(&cfg));
+  CHECK_EQ(emu.totalWrites(), 0);
+
+  // only the changed fields are written
+  cfg.apa = LC709203F_APA_3000MAH;
+  cfg.alarm_rsoc = 5;
+  uint8_t changed = LC709203F_CONFIG_APA | LC709203F_CONFIG_ALARMRSOC;
+  CHECK_EQ(lc.diffConfig(&cfg), changed);
+  emu.clear();
+  CHECK(lc.applyConfig(&cfg));
+  check_written_once(emu, changed);
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_APA), LC709203F_APA_3000MAH);
+
+  // fields left out of 'fields' are never compared or written
+  cfg.fields = LC709203F_CONFIG_POWERMODE;
+  cfg.thermistor_b = 1234;
+  CHECK_EQ(lc.diffConfig(&cfg), 0);
+
+  // a setter keeps the known state current
+  CHECK(lc.setPowerMode(LC709203F_POWER_SLEEP));
+  CHECK_EQ(lc.diffConfig(&cfg), LC709203F_CONFIG_POWERMODE);
+
+  // a failed write leaves its field dirty, so the next apply retries it
+  emu.clear();
+  emu.injectNack(1);
+  CHECK(!lc.applyConfig(&cfg));
+  CHECK_EQ(lc.diffConfig(&cfg), LC709203F_CONFIG_POWERMODE);
+  CHECK(lc.applyConfig(&cfg));
+  CHECK_EQ(lc.diffConfig(&cfg), 0);
+  CHECK_EQ(emu.writes[LC709203F_CMD_POWERMODE], 2);
+
+  // once the chip state is unknown, every staged field is dirty again
+  Adafruit_LC709203F::defaultConfig(&cfg);
+  lc.invalidateCache();
+  CHECK_EQ(lc.diffConfig(&cfg), cfg.fields);
+  emu.clear();
+  CHECK(lc.applyConfig(&cfg));
+  check_written_once(emu, cfg.fields);
+
+  return lc709_test_done();
+}
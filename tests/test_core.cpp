@@ -0,0 +1,55 @@
+// Adafruit_LC709203F_Core over a bus with only the two BusIO methods, the
+// shape of Adafruit_I2CDevice, at the default and a non-default address
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+// just write() and write_then_read(), no Transport base class
+class PlainDevice {
+public:
+  explicit PlainDevice(Adafruit_LC709203F_Emulator *emu) : _emu(emu) {}
+  bool write(const uint8_t *buffer, size_t len) {
+    return _emu->write(buffer, len);
+  }
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len) {
+    return _emu->write_then_read(write_buffer, write_len, read_buffer,
+                                 read_len);
+  }
+
+private:
+  Adafruit_LC709203F_Emulator *_emu;
+};
+
+template <uint8_t Address> static void check_address(void) {
+  Adafruit_LC709203F_Emulator emu(Address);
+  PlainDevice dev(&emu);
+  Adafruit_LC709203F_Core<PlainDevice, Address> core(&dev);
+
+  uint16_t v = 0;
+  CHECK(core.template readRegister<LC709203F_CMD_ICVERSION>(&v));
+  CHECK_EQ(v, emu.getRegister(LC709203F_CMD_ICVERSION));
+  CHECK(core.readWord(LC709203F_CMD_CELLVOLTAGE, &v));
+  CHECK_EQ(v, emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+
+  CHECK(core.template writeRegister<LC709203F_CMD_THERMISTORB>(3950));
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_THERMISTORB), 3950);
+  CHECK(core.writeWord(LC709203F_CMD_APA, 0x2D));
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_APA), 0x2D);
+  CHECK_EQ(emu.crc_errors, 0);
+
+  emu.injectCRCError(1);
+  bool acked = false;
+  CHECK(!core.readWord(LC709203F_CMD_CELLITE, &v, &acked));
+  CHECK(acked);
+  emu.injectNack(1);
+  CHECK(!core.readWord(LC709203F_CMD_CELLITE, &v, &acked));
+  CHECK(!acked);
+}
+
+int main() {
+  check_address<LC709203F_I2CADDR_DEFAULT>();
+  check_address<0x2A>();
+  return lc709_test_done();
+}
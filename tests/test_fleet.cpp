@@ -0,0 +1,111 @@
+// Fleet scans: a lone gauge on a bare emulator, gauges behind muxes on two
+// buses, and a stuck gauge that must time out without stalling the rest
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Fleet.h"
+#include "lc709203f_mux_bus.h"
+#include "lc709203f_test.h"
+
+static void check_snapshot(const lc709203_snapshot_t &s,
+                           const Adafruit_LC709203F_Emulator &emu) {
+  CHECK_EQ(s.valid, LC709203F_SNAPSHOT_ALL);
+  CHECK_EQ(s.voltage, emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(s.ite, emu.getRegister(LC709203F_CMD_CELLITE));
+  CHECK_EQ(s.rsoc, emu.getRegister(LC709203F_CMD_RSOC));
+  CHECK_EQ(s.temperature, emu.getRegister(LC709203F_CMD_CELLTEMPERATURE));
+}
+
+int main() {
+  // one gauge straight on an emulator, nobody calling advance()
+  {
+    Adafruit_LC709203F_Emulator emu;
+    Adafruit_LC709203F g;
+    CHECK(g.begin(&emu));
+    emu.setBattery(500, 640);
+    lc709203_fleet_member_t members[1];
+    Adafruit_LC709203F_Fleet fleet(members, 1);
+    CHECK_EQ(fleet.add(&g, 0), 0);
+    CHECK_EQ(fleet.add(&g, 0), -1);
+    lc709203_snapshot_t snaps[1];
+    CHECK_EQ(fleet.scan(snaps), 1);
+    check_snapshot(snaps[0], emu);
+    CHECK_EQ(fleet.scans, 1);
+  }
+
+  // a gauge that never answers in time on bus 1: every one of its reads
+  // hits the deadline, the gauge on bus 0 is read regardless
+  {
+    Adafruit_LC709203F_Emulator fast, stuck;
+    Adafruit_LC709203F a, b;
+    CHECK(a.begin(&fast));
+    CHECK(b.begin(&stuck));
+    stuck.setLatency(1000000);
+    lc709203_fleet_member_t members[2];
+    Adafruit_LC709203F_Fleet fleet(members, 2);
+    CHECK_EQ(fleet.add(&a, 0), 0);
+    CHECK_EQ(fleet.add(&b, 1), 1);
+    lc709203_snapshot_t snaps[2];
+    uint64_t t0 = stuck.virtualMicros();
+    CHECK_EQ(fleet.scan(snaps), 1);
+    check_snapshot(snaps[0], fast);
+    CHECK_EQ(snaps[1].valid, 0);
+    uint64_t t = stuck.virtualMicros() - t0;
+    CHECK(t >= 4 * LC709203F_READ_TIMEOUT_US);
+    CHECK(t < 4 * (LC709203F_READ_TIMEOUT_US + 100));
+
+    // the transport was freed, so the gauge works once it recovers
+    stuck.setLatency(0);
+    CHECK_EQ(fleet.scan(snaps), 2);
+    check_snapshot(snaps[1], stuck);
+
+    // a longer deadline lets a slow gauge finish
+    stuck.setLatency(50000);
+    CHECK_EQ(fleet.scan(snaps), 1);
+    b.setReadTimeout(60000);
+    CHECK_EQ(fleet.scan(snaps), 2);
+    b.setReadTimeout(0);
+    CHECK_EQ(fleet.scan(snaps), 2);
+  }
+
+  // eight gauges behind a mux on each of two buses
+  {
+    MuxBus bus[2];
+    MuxControl ctrl0(&bus[0]), ctrl1(&bus[1]);
+    Adafruit_LC709203F_Mux mux0(&ctrl0), mux1(&ctrl1);
+    Adafruit_LC709203F_Mux *mux[2] = {&mux0, &mux1};
+    Adafruit_LC709203F_MuxChannel *ch[16];
+    Adafruit_LC709203F g[16];
+    lc709203_fleet_member_t members[16];
+    Adafruit_LC709203F_Fleet fleet(members, 16);
+
+    // added out of order, snapshots still come back in add() order
+    for (int i = 0; i < 16; i++) {
+      int b = i % 2, c = 7 - i / 2;
+      bus[b].gauge[c].setBattery(500, 100 + i * 50);
+      ch[i] = new Adafruit_LC709203F_MuxChannel(&bus[b], mux[b], c);
+      CHECK(g[i].begin(ch[i]));
+      CHECK_EQ(fleet.add(&g[i], b, mux[b], c), i);
+    }
+    lc709203_snapshot_t snaps[16];
+    uint32_t switches = mux0.switches;
+    CHECK_EQ(fleet.scan(snaps), 16);
+    for (int i = 0; i < 16; i++)
+      check_snapshot(snaps[i], bus[i % 2].gauge[7 - i / 2]);
+    // walking 0..7 from channel 0 (selected last by begin()) costs 7
+    // writes, the next scan walks back 7..0 from 7 for another 7
+    CHECK_EQ(mux0.switches - switches, 7);
+    CHECK_EQ(fleet.scan(snaps), 16);
+    CHECK_EQ(mux0.switches - switches, 14);
+
+    // a gauge that NACKs is marked invalid, its neighbours are not
+    bus[0].gauge[3].injectNack(1);
+    CHECK_EQ(fleet.scan(snaps), 15);
+    CHECK_EQ(snaps[8].valid, LC709203F_SNAPSHOT_ALL & ~1);
+
+    for (int i = 0; i < 16; i++)
+      delete ch[i];
+  }
+
+  return lc709_test_done();
+}
@@ -0,0 +1,72 @@
+// Bus health counters and latency histograms kept in caller storage, or
+// refused when the library is built without LC709203F_INSTRUMENT
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+#include <string.h>
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  CHECK(lc.counters() == NULL);
+  uint16_t h[LC709203F_LATENCY_BUCKETS];
+  CHECK(!lc.getLatency(LC709203F_CMD_CELLVOLTAGE, h));
+  lc.resetCounters();
+
+#ifdef LC709203F_INSTRUMENT
+  lc709203_instrument_t storage;
+  memset(&storage, 0xFF, sizeof(storage));
+  CHECK(lc.setInstrumentation(&storage));
+  CHECK(lc.counters() == &storage.counters);
+  CHECK_EQ(storage.counters.transactions, 0);
+  CHECK_EQ(storage.latency[0][LC709203F_LATENCY_BUCKETS - 1], 0);
+
+  emu.setLatency(50);
+  CHECK_EQ(lc.tryCellVoltage().error, LC709203F_OK);
+  CHECK_EQ(storage.counters.transactions, 1);
+  CHECK(lc.getLatency(LC709203F_CMD_CELLVOLTAGE, h));
+  uint32_t sum = 0;
+  for (uint8_t b = 0; b < LC709203F_LATENCY_BUCKETS; b++)
+    sum += h[b];
+  CHECK_EQ(sum, 1);
+  CHECK(!lc.getLatency(0x42, h));
+
+  // one NACK and one bad CRC, each retried once
+  lc709203_retry_t policy = {3, LC709203F_RETRY_NACK | LC709203F_RETRY_CRC,
+                             0, 0, 0};
+  lc.setRetryPolicy(&policy);
+  emu.injectNack(1);
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+  emu.injectCRCError(1);
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+  const lc709203_counters_t *c = lc.counters();
+  CHECK_EQ(c->transactions, 5);
+  CHECK_EQ(c->nacks, 1);
+  CHECK_EQ(c->crc_errors, 1);
+  CHECK_EQ(c->retries, 2);
+
+  lc.setRetryPolicy(NULL);
+  CHECK(lc.setPackAPA(0x2D));
+  CHECK_EQ(c->transactions, 6);
+
+  lc.resetCounters();
+  CHECK_EQ(c->transactions, 0);
+  CHECK(lc.getLatency(LC709203F_CMD_CELLVOLTAGE, h));
+  CHECK_EQ(h[0], 0);
+
+  // detached, nothing more is counted
+  CHECK(lc.setInstrumentation(NULL));
+  CHECK(lc.counters() == NULL);
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+  CHECK_EQ(storage.counters.transactions, 0);
+#else
+  lc709203_instrument_t storage;
+  CHECK(!lc.setInstrumentation(&storage));
+  CHECK(lc.counters() == NULL);
+  CHECK(lc.setInstrumentation(NULL));
+#endif
+
+  return lc709_test_done();
+}
@@ -0,0 +1,95 @@
+// The i2c-dev transport against a userspace stand-in for the adapter:
+// ioctls per read and per snapshot, the per-transfer fallback after a
+// NACK, timeouts, batches over the kernel's message limit, and a missing
+// adapter
+
+#include "Adafruit_LC709203F.h"
+#include "lc709203f_fake_i2c.h"
+#include "lc709203f_test.h"
+
+int main() {
+  FakeAdapter bus;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&bus));
+  bus.emu.setBattery(500, 730);
+
+  // a register read is one ioctl: command write, repeated start, 3 bytes
+  uint32_t ioctls = bus.ioctls, messages = bus.messages;
+  uint16_t mv;
+  CHECK(lc.readCellVoltage(&mv));
+  CHECK_EQ(mv, bus.emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(bus.ioctls - ioctls, 1);
+  CHECK_EQ(bus.messages - messages, 2);
+
+  // a snapshot is one ioctl for all four reads
+  lc709203_snapshot_t snap;
+  ioctls = bus.ioctls;
+  messages = bus.messages;
+  CHECK(lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid, LC709203F_SNAPSHOT_ALL);
+  CHECK_EQ(snap.ite, 730);
+  CHECK_EQ(snap.voltage, bus.emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(bus.ioctls - ioctls, 1);
+  CHECK_EQ(bus.messages - messages, 8);
+
+  // a NACK fails the batch ioctl, then each read is sent on its own to
+  // find the bad one: 1 + 4 ioctls, and the NACK was transient
+  bus.emu.injectNack(1);
+  ioctls = bus.ioctls;
+  CHECK(lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid, LC709203F_SNAPSHOT_ALL);
+  CHECK_EQ(bus.ioctls - ioctls, 5);
+
+  // a NACK that persists into the fallback only loses that register
+  bus.emu.injectNack(2);
+  ioctls = bus.ioctls;
+  CHECK(!lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid, LC709203F_SNAPSHOT_ALL & ~LC709203F_SNAPSHOT_VOLTAGE);
+  CHECK_EQ(bus.ioctls - ioctls, 5);
+
+  // the next snapshot is back to one ioctl
+  ioctls = bus.ioctls;
+  CHECK(lc.readSnapshot(&snap));
+  CHECK_EQ(bus.ioctls - ioctls, 1);
+
+  // ETIMEDOUT is told apart from a NACK
+  bus.time_out = true;
+  CHECK_EQ(lc.tryCellVoltage().error, LC709203F_ERR_TIMEOUT);
+  bus.time_out = false;
+  bus.emu.injectNack(1);
+  CHECK_EQ(lc.tryCellVoltage().error, LC709203F_ERR_NACK);
+  CHECK_EQ(lc.tryCellVoltage().error, LC709203F_OK);
+
+  // writes are a single message
+  ioctls = bus.ioctls;
+  messages = bus.messages;
+  CHECK(lc.setThermistorB(3950));
+  CHECK_EQ(bus.ioctls - ioctls, 1);
+  CHECK_EQ(bus.messages - messages, 1);
+
+  // the kernel takes at most 42 messages per ioctl, so 25 reads need 2
+  uint8_t cmd = LC709203F_CMD_ICVERSION, replies[25][3];
+  lc709203_xfer_t xfers[25];
+  for (int i = 0; i < 25; i++) {
+    xfers[i].write_buffer = &cmd;
+    xfers[i].write_len = 1;
+    xfers[i].read_buffer = replies[i];
+    xfers[i].read_len = 3;
+  }
+  ioctls = bus.ioctls;
+  CHECK(bus.write_then_read_batch(xfers, 25));
+  CHECK_EQ(bus.ioctls - ioctls, 2);
+  for (int i = 0; i < 25; i++) {
+    CHECK(xfers[i].ok);
+    CHECK_EQ(replies[i][0] | replies[i][1] << 8,
+             bus.emu.getRegister(LC709203F_CMD_ICVERSION));
+  }
+
+  // a missing adapter fails begin() cleanly
+  Adafruit_LC709203F_LinuxI2C missing("/nonexistent/i2c-99");
+  Adafruit_LC709203F absent;
+  CHECK(!missing.begin());
+  CHECK(!absent.begin(&missing));
+
+  return lc709_test_done();
+}
@@ -0,0 +1,128 @@
+// Log blocks: a discharge trace read through the driver encodes and
+// decodes back exactly, including worst case jumps and invalid fields, and
+// damaged blocks are rejected
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Log.h"
+#include "lc709203f_test.h"
+#include <string.h>
+#include <vector>
+
+typedef std::vector<uint8_t> Block;
+
+static void keep_block(void *ctx, const uint8_t *block, uint16_t len) {
+  static_cast<std::vector<Block> *>(ctx)->push_back(Block(block, block + len));
+}
+
+static bool same(const lc709203_sample_t &a, const lc709203_sample_t &b) {
+  return a.timestamp == b.timestamp && a.data.voltage == b.data.voltage &&
+         a.data.ite == b.data.ite && a.data.rsoc == b.data.rsoc &&
+         a.data.temperature == b.data.temperature &&
+         a.data.valid == b.data.valid;
+}
+
+// decode every block, appending to 'out'; false if any block is rejected
+static bool decode_all(const std::vector<Block> &blocks,
+                       std::vector<lc709203_sample_t> *out) {
+  Adafruit_LC709203F_LogDecoder dec;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    if (!dec.begin(blocks[i].data(), blocks[i].size()))
+      return false;
+    lc709203_sample_t s;
+    uint8_t n = 0;
+    while (dec.next(&s)) {
+      out->push_back(s);
+      n++;
+    }
+    if (n != dec.count())
+      return false;
+  }
+  return true;
+}
+
+// records what the driver read, next to the encoder under test
+class Recorder : public Adafruit_LC709203F_SampleSink {
+public:
+  void addSample(const lc709203_sample_t &sample) { all.push_back(sample); }
+  std::vector<lc709203_sample_t> all;
+};
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  lc.setTemperatureMode(LC709203F_TEMPERATURE_THERMISTOR);
+
+  std::vector<Block> blocks;
+  uint8_t page[256];
+  Adafruit_LC709203F_LogEncoder enc(page, sizeof(page), keep_block, &blocks,
+                                    100);
+  Recorder rec;
+  lc.addSampleSink(&enc);
+  lc.addSampleSink(&rec);
+
+  // a discharge with load steps, temperature drift and the odd failed read
+  for (int i = 0; i < 3000; i++) {
+    emu.step(i % 97 == 0 ? 20000 : 1000, i % 600 < 30 ? 1200 : 250);
+    emu.setTemperature(2982 + (i / 50) % 40);
+    if (i % 211 == 0)
+      emu.injectNack(1);
+    lc709203_snapshot_t snap;
+    lc.readSnapshot(&snap);
+  }
+  // worst case deltas: full scale swings and an invalid sample
+  lc709203_sample_t s;
+  memset(&s, 0, sizeof(s));
+  s.timestamp = rec.all.back().timestamp + 0x7FFFFFFF;
+  rec.all.push_back(s);
+  enc.add(s);
+  s.timestamp += 1;
+  s.data.voltage = s.data.ite = s.data.rsoc = s.data.temperature = 0xFFFF;
+  s.data.valid = LC709203F_SNAPSHOT_ALL;
+  rec.all.push_back(s);
+  enc.add(s);
+  enc.flush();
+
+  CHECK_EQ(enc.samples, rec.all.size());
+  std::vector<lc709203_sample_t> out;
+  CHECK(decode_all(blocks, &out));
+  CHECK_EQ(out.size(), rec.all.size());
+  size_t mismatched = 0;
+  for (size_t i = 0; i < out.size() && i < rec.all.size(); i++)
+    if (!same(out[i], rec.all[i]))
+      mismatched++;
+  CHECK_EQ(mismatched, 0);
+  CHECK(blocks.size() > 1);
+
+  size_t total = 0;
+  for (size_t i = 0; i < blocks.size(); i++)
+    total += blocks[i].size();
+  CHECK_EQ(total, enc.bytes);
+  // well under the 13 bytes of a raw sample
+  CHECK(total < rec.all.size() * 10);
+
+  // any single flipped bit, or a truncated block, is caught
+  Adafruit_LC709203F_LogDecoder dec;
+  Block b = blocks[1];
+  int accepted = 0;
+  for (size_t i = 0; i < b.size() * 8; i++) {
+    Block bad = b;
+    bad[i / 8] ^= 1 << (i % 8);
+    if (dec.begin(bad.data(), bad.size()))
+      accepted++;
+  }
+  CHECK_EQ(accepted, 0);
+  CHECK(!dec.begin(b.data(), b.size() - 1));
+  CHECK(dec.begin(b.data(), b.size()));
+
+  // a bad block does not stop the next one decoding
+  std::vector<Block> damaged(blocks.begin(), blocks.begin() + 3);
+  damaged[1][10] ^= 0x40;
+  CHECK(dec.begin(damaged[2].data(), damaged[2].size()));
+  CHECK(dec.next(&s));
+  CHECK(!dec.begin(damaged[1].data(), damaged[1].size()));
+  CHECK(!dec.next(&s));
+
+  return lc709_test_done();
+}
@@ -0,0 +1,78 @@
+// The adaptive poller backs off while readings are stable, drops to the
+// minimum interval on a transient, near the alarm levels (given in the
+// units of setAlarmMillivolts() and setAlarmRSOC()) and on failed reads,
+// and keeps to its bus budget
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Poller.h"
+#include "lc709203f_test.h"
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  emu.setBattery(1000, 800);
+
+  Adafruit_LC709203F_Poller poller(&lc, 1000, 60000);
+  uint32_t now = 0;
+  CHECK(poller.poll(now));
+  CHECK_EQ(poller.interval(), 1000);
+  CHECK(!poller.poll(now + 999)); // not due
+
+  // stable: the interval grows to the maximum
+  for (int i = 0; i < 40; i++) {
+    now = poller.nextPoll();
+    emu.step(1, 0);
+    poller.poll(now);
+  }
+  CHECK_EQ(poller.interval(), 60000);
+
+  // a load step moves the voltage by many bands: straight to the minimum
+  now = poller.nextPoll();
+  emu.step(1, 1500);
+  CHECK(poller.poll(now));
+  CHECK_EQ(poller.interval(), 1000);
+
+  // near the RSOC alarm, in whole percent like setAlarmRSOC(): 80% is
+  // within 2% of 79%, but not of 70%
+  Adafruit_LC709203F_Poller near(&lc, 1000, 60000);
+  near.setAlarmLevels(0, 70, 0, 2);
+  emu.step(1, 0);
+  for (int i = 0; i < 10; i++)
+    near.poll(near.nextPoll());
+  CHECK(near.interval() > 1000);
+  near.setAlarmLevels(0, 79, 0, 2);
+  near.poll(near.nextPoll());
+  CHECK_EQ(near.interval(), 1000);
+
+  // and the voltage level, in mV
+  uint16_t mv = emu.getRegister(LC709203F_CMD_CELLVOLTAGE);
+  Adafruit_LC709203F_Poller vnear(&lc, 1000, 60000);
+  vnear.setAlarmLevels(mv - 50, 0, 20, 0);
+  for (int i = 0; i < 10; i++)
+    vnear.poll(vnear.nextPoll());
+  CHECK(vnear.interval() > 1000);
+  vnear.setAlarmLevels(mv - 10, 0, 20, 0);
+  vnear.poll(vnear.nextPoll());
+  CHECK_EQ(vnear.interval(), 1000);
+
+  // a failed read retries at the minimum and keeps the last good values
+  for (int i = 0; i < 10; i++)
+    poller.poll(poller.nextPoll());
+  uint16_t good = poller.last().voltage;
+  emu.injectNack(4);
+  CHECK(!poller.poll(poller.nextPoll()));
+  CHECK_EQ(poller.interval(), 1000);
+  CHECK_EQ(poller.last().voltage, good);
+
+  // budget: 3 snapshots per 10 s, however often it is asked
+  Adafruit_LC709203F_Poller capped(&lc, 10, 10);
+  capped.setBusBudget(3, 10000);
+  uint32_t t0 = poller.nextPoll();
+  for (uint32_t t = 0; t < 30000; t += 10)
+    capped.poll(t0 + t);
+  CHECK_EQ(capped.polls, 9);
+
+  return lc709_test_done();
+}
@@ -0,0 +1,75 @@
+// The try*() getters: values at the edges of the valid ranges pass,
+// values just outside them and failed reads come back as 0 with the reason
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+typedef lc709203_result_t (Adafruit_LC709203F::*getter_t)(void);
+
+// sets the register behind 'get' to 'raw' and checks what comes back
+static void check(Adafruit_LC709203F_Emulator &emu, Adafruit_LC709203F &lc,
+                  getter_t get, uint8_t command, uint16_t raw,
+                  lc709203_error_t want) {
+  emu.setRegister(command, raw);
+  lc709203_result_t r = (lc.*get)();
+  CHECK_EQ(r.error, want);
+  CHECK_EQ(r.value, want == LC709203F_OK ? raw : 0);
+}
+
+// the edges of [min, max] pass, one step outside them does not
+static void check_range(Adafruit_LC709203F_Emulator &emu,
+                        Adafruit_LC709203F &lc, getter_t get, uint8_t command,
+                        uint16_t min, uint16_t max) {
+  check(emu, lc, get, command, min, LC709203F_OK);
+  check(emu, lc, get, command, max, LC709203F_OK);
+  if (min > 0)
+    check(emu, lc, get, command, min - 1, LC709203F_ERR_RANGE);
+  check(emu, lc, get, command, max + 1, LC709203F_ERR_RANGE);
+  check(emu, lc, get, command, 0xFFFF, LC709203F_ERR_RANGE);
+}
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+
+  check_range(emu, lc, &Adafruit_LC709203F::tryCellVoltage,
+              LC709203F_CMD_CELLVOLTAGE, LC709203F_VOLTAGE_MIN,
+              LC709203F_VOLTAGE_MAX);
+  check(emu, lc, &Adafruit_LC709203F::tryCellVoltage,
+        LC709203F_CMD_CELLVOLTAGE, 0, LC709203F_ERR_RANGE);
+  check_range(emu, lc, &Adafruit_LC709203F::tryCellPercent,
+              LC709203F_CMD_CELLITE, 0, 1000);
+  check_range(emu, lc, &Adafruit_LC709203F::tryCellRSOC, LC709203F_CMD_RSOC,
+              0, 100);
+  check_range(emu, lc, &Adafruit_LC709203F::tryCellTemperature,
+              LC709203F_CMD_CELLTEMPERATURE, LC709203F_TEMP_MIN,
+              LC709203F_TEMP_MAX);
+  check(emu, lc, &Adafruit_LC709203F::tryCellTemperature,
+        LC709203F_CMD_CELLTEMPERATURE, 0, LC709203F_ERR_RANGE);
+
+  // raw reads have no range to leave
+  emu.setRegister(LC709203F_CMD_CELLVOLTAGE, 0xFFFF);
+  lc709203_result_t r = lc.tryRead(LC709203F_CMD_CELLVOLTAGE);
+  CHECK_EQ(r.error, LC709203F_OK);
+  CHECK_EQ(r.value, 0xFFFF);
+  check(emu, lc, &Adafruit_LC709203F::tryICversion, LC709203F_CMD_ICVERSION,
+        0xFFFF, LC709203F_OK);
+
+  // a read that failed is told apart from an out of range one
+  emu.setRegister(LC709203F_CMD_RSOC, 50);
+  emu.injectNack(1);
+  r = lc.tryCellRSOC();
+  CHECK_EQ(r.error, LC709203F_ERR_NACK);
+  CHECK_EQ(r.value, 0);
+  emu.injectCRCError(1);
+  r = lc.tryCellRSOC();
+  CHECK_EQ(r.error, LC709203F_ERR_CRC);
+  CHECK_EQ(r.value, 0);
+  r = lc.tryCellRSOC();
+  CHECK_EQ(r.error, LC709203F_OK);
+  CHECK_EQ(r.value, 50);
+
+  return lc709_test_done();
+}
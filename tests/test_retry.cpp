@@ -0,0 +1,94 @@
+// Retry backoff: the waits between tries, capped by max_backoff_us (or
+// not, when it is 0), and the time budget that ends the retries early
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+#include <vector>
+
+// an emulator that records every wait the driver asks for
+class WaitLog : public Adafruit_LC709203F_Emulator {
+public:
+  std::vector<uint32_t> waits;
+  void delayMicros(uint32_t us) {
+    waits.push_back(us);
+    Adafruit_LC709203F_Emulator::delayMicros(us);
+  }
+};
+
+// a read that NACKs 'nacks' times under 'policy', returns its result and
+// leaves the waits it took in emu.waits
+static lc709203_result_t nacked_read(WaitLog &emu, Adafruit_LC709203F &lc,
+                                     const lc709203_retry_t &policy,
+                                     uint8_t nacks) {
+  lc.setRetryPolicy(&policy);
+  emu.waits.clear();
+  emu.injectNack(nacks);
+  lc709203_result_t r = lc.tryCellRSOC();
+  emu.injectNack(0);
+  return r;
+}
+
+static void check_waits(const std::vector<uint32_t> &got,
+                        std::vector<uint32_t> want) {
+  CHECK_EQ(got.size(), want.size());
+  for (size_t i = 0; i < got.size() && i < want.size(); i++)
+    CHECK_EQ(got[i], want[i]);
+}
+
+int main() {
+  WaitLog emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+
+  // doubling up to the cap
+  lc709203_retry_t p = {6, LC709203F_RETRY_NACK, 100, 500, 0};
+  CHECK_EQ(nacked_read(emu, lc, p, 5).error, LC709203F_OK);
+  check_waits(emu.waits, {100, 200, 400, 500, 500});
+
+  // a first wait longer than the cap is cut down to it
+  p.backoff_us = 2000;
+  CHECK_EQ(nacked_read(emu, lc, p, 3).error, LC709203F_OK);
+  check_waits(emu.waits, {500, 500, 500});
+
+  // no cap: doubling until it saturates
+  p.backoff_us = 20000;
+  p.max_backoff_us = 0;
+  CHECK_EQ(nacked_read(emu, lc, p, 3).error, LC709203F_OK);
+  check_waits(emu.waits, {20000, 40000, 65535});
+
+  // no backoff at all
+  p.backoff_us = 0;
+  CHECK_EQ(nacked_read(emu, lc, p, 3).error, LC709203F_OK);
+  check_waits(emu.waits, {});
+  CHECK_EQ(lc.retryCount(), 5 + 3 + 3 + 3);
+
+  // out of tries: the last failure is returned
+  p.backoff_us = 100;
+  p.max_backoff_us = 500;
+  p.attempts = 3;
+  CHECK_EQ(nacked_read(emu, lc, p, 5).error, LC709203F_ERR_NACK);
+  check_waits(emu.waits, {100, 200});
+
+  // a budget that runs out before the third try stops early, as a timeout
+  lc.setRetryPolicy(NULL);
+  uint64_t t0 = emu.virtualMicros();
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+  uint32_t one = emu.virtualMicros() - t0;
+  p.attempts = 6;
+  p.budget_us = 2 * one + 100 + 200 + 1;
+  CHECK_EQ(nacked_read(emu, lc, p, 5).error, LC709203F_ERR_TIMEOUT);
+  check_waits(emu.waits, {100, 200});
+
+  // CRC failures are only retried when asked for
+  p.budget_us = 0;
+  lc.setRetryPolicy(&p);
+  emu.injectCRCError(1);
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_ERR_CRC);
+  p.retry_on |= LC709203F_RETRY_CRC;
+  lc.setRetryPolicy(&p);
+  emu.injectCRCError(1);
+  CHECK_EQ(lc.tryCellRSOC().error, LC709203F_OK);
+
+  return lc709_test_done();
+}
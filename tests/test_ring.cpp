@@ -0,0 +1,139 @@
+// The SPSC sample ring: a producer and a consumer thread hammer it, and
+// every sample must arrive once, in order and untorn. Build with
+// CXXFLAGS="-std=gnu++11 -O1 -g -fsanitize=thread" to also race-check it
+
+#include "Adafruit_LC709203F_SampleRing.h"
+#include "lc709203f_test.h"
+#include <sched.h>
+#include <thread>
+
+#define SAMPLES 200000
+
+// every field derived from the sequence number, so a torn copy shows up
+static void make_sample(uint32_t seq, lc709203_sample_t *s) {
+  s->timestamp = seq;
+  s->data.voltage = (uint16_t)(seq * 3);
+  s->data.ite = (uint16_t)(seq >> 3);
+  s->data.rsoc = (uint16_t)~seq;
+  s->data.temperature = (uint16_t)(seq ^ 0x5A5A);
+  s->data.valid = (uint8_t)seq;
+}
+
+static bool intact(const lc709203_sample_t &s) {
+  lc709203_sample_t want;
+  make_sample(s.timestamp, &want);
+  return s.data.voltage == want.data.voltage && s.data.ite == want.data.ite &&
+         s.data.rsoc == want.data.rsoc &&
+         s.data.temperature == want.data.temperature &&
+         s.data.valid == want.data.valid;
+}
+
+int main() {
+  static lc709203_sample_t storage[16];
+
+  // lossless: the producer retries a refused push until there is space
+  {
+    Adafruit_LC709203F_SampleRing ring(storage, 16);
+    CHECK_EQ(ring.capacity(), 16);
+    uint32_t torn = 0, out_of_order = 0, received = 0;
+    std::thread consumer([&] {
+      lc709203_sample_t s;
+      while (received < SAMPLES) {
+        if (!ring.pop(&s)) {
+          sched_yield();
+          continue;
+        }
+        if (!intact(s))
+          torn++;
+        if (s.timestamp != received)
+          out_of_order++;
+        received++;
+      }
+    });
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+      lc709203_sample_t s;
+      make_sample(i, &s);
+      while (!ring.push(s))
+        sched_yield();
+    }
+    consumer.join();
+    CHECK_EQ(received, SAMPLES);
+    CHECK_EQ(torn, 0);
+    CHECK_EQ(out_of_order, 0);
+  }
+
+  // as a sink the producer never waits: drops are counted, never lost
+  // silently, the count can be watched from the consumer, and what arrives
+  // is still in order and untorn
+  {
+    Adafruit_LC709203F_SampleRing ring(storage, 13); // rounds down to 8
+    CHECK_EQ(ring.capacity(), 8);
+    volatile bool done = false;
+    uint32_t torn = 0, backwards = 0, received = 0, shrank = 0;
+    std::thread consumer([&] {
+      lc709203_sample_t s;
+      int64_t last = -1;
+      lc709_ring_index_t seen = 0;
+      for (;;) {
+        bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+        lc709_ring_index_t drops = ring.dropped();
+        if (drops < seen)
+          shrank++;
+        seen = drops;
+        if (!ring.pop(&s)) {
+          if (finished)
+            break;
+          sched_yield();
+          continue;
+        }
+        if (!intact(s))
+          torn++;
+        if ((int64_t)s.timestamp <= last)
+          backwards++;
+        last = s.timestamp;
+        received++;
+      }
+    });
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+      lc709203_sample_t s;
+      make_sample(i, &s);
+      ring.addSample(s);
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    consumer.join();
+    CHECK_EQ(received + ring.dropped(), SAMPLES);
+    CHECK_EQ(torn, 0);
+    CHECK_EQ(backwards, 0);
+    CHECK_EQ(shrank, 0);
+  }
+
+  // storage that is not a power of two is only used up to one
+  {
+    static lc709203_sample_t big[100];
+    Adafruit_LC709203F_SampleRing ring(big, 100);
+    CHECK_EQ(ring.capacity(), 64);
+    lc709203_sample_t s;
+    make_sample(1, &s);
+    for (int i = 0; i < 100; i++)
+      ring.push(s);
+    CHECK_EQ(ring.available(), 64);
+    CHECK_EQ(ring.dropped(), 36);
+  }
+
+  // no slots: always full, nothing is written
+  {
+    lc709203_sample_t guard;
+    make_sample(7, &guard);
+    lc709203_sample_t zero[1] = {guard};
+    Adafruit_LC709203F_SampleRing ring(zero, 0);
+    CHECK_EQ(ring.capacity(), 0);
+    lc709203_sample_t s;
+    make_sample(1, &s);
+    CHECK(!ring.push(s));
+    CHECK_EQ(ring.dropped(), 1);
+    CHECK(!ring.pop(&s));
+    CHECK_EQ(zero[0].timestamp, 7);
+  }
+
+  return lc709_test_done();
+}
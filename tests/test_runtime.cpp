@@ -0,0 +1,114 @@
+// Time to empty and time to full estimates against the emulator's actual
+// discharge and charge times, and the idle case
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Runtime.h"
+#include "lc709203f_test.h"
+#include <vector>
+
+#ifndef LC709203F_NO_FLOAT
+
+#define PERIOD_MS 10000
+
+struct point {
+  uint32_t t;
+  bool ok;
+  lc709203_runtime_t est;
+};
+
+// runs at 'load_ma' until the cell is empty (full), estimating after every
+// sample, then checks the estimates against the time it actually took
+static void check_trend(int16_t load_ma, uint16_t start_x10,
+                        lc709203_runtime_state_t state) {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  Adafruit_LC709203F_Runtime rt(600);
+  CHECK(lc.begin(&emu));
+  emu.setBattery(500, start_x10);
+  lc.addSampleSink(&rt);
+
+  uint16_t end = load_ma > 0 ? 0 : 1000;
+  std::vector<point> trace;
+  while (emu.getRegister(LC709203F_CMD_CELLITE) != end) {
+    emu.step(PERIOD_MS, load_ma);
+    lc709203_snapshot_t snap;
+    CHECK(lc.readSnapshot(&snap));
+    point p;
+    p.t = emu.nowMillis() / 1000;
+    p.ok = rt.estimate(&p.est);
+    trace.push_back(p);
+  }
+  uint32_t done = trace.back().t;
+
+  // after the fit has settled (three time constants), while there is
+  // some way left to go
+  int checked = 0, bounded = 0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    uint32_t actual = done - trace[i].t;
+    if (trace[i].t - trace[0].t < 1800 || actual < 600)
+      continue;
+    CHECK(trace[i].ok);
+    CHECK_EQ(trace[i].est.state, state);
+    uint32_t err = trace[i].est.seconds > actual
+                       ? trace[i].est.seconds - actual
+                       : actual - trace[i].est.seconds;
+    // within 1%, plus the time one 0.1% ITE step takes
+    CHECK(err <= actual / 100 + 18);
+    CHECK(trace[i].est.seconds_min <= trace[i].est.seconds);
+    CHECK(trace[i].est.seconds <= trace[i].est.seconds_max);
+    if (trace[i].est.seconds_min <= actual &&
+        actual <= trace[i].est.seconds_max)
+      bounded++;
+    checked++;
+  }
+  CHECK(checked > 100);
+  // two standard errors should hold the actual time nearly always
+  CHECK(bounded * 100 >= checked * 95);
+}
+
+int main() {
+  check_trend(300, 1000, LC709203F_RUNTIME_DISCHARGING);
+  check_trend(-300, 200, LC709203F_RUNTIME_CHARGING);
+
+  // no load: no trend, and no time given
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  Adafruit_LC709203F_Runtime rt(600);
+  CHECK(lc.begin(&emu));
+  lc.addSampleSink(&rt);
+  lc709203_runtime_t est;
+  lc709203_snapshot_t snap;
+  for (int i = 0; i < 2; i++) {
+    emu.step(PERIOD_MS, 0);
+    CHECK(lc.readSnapshot(&snap));
+  }
+  CHECK(!rt.estimate(&est)); // too few samples to fit
+  for (int i = 0; i < 200; i++) {
+    emu.step(PERIOD_MS, 0);
+    CHECK(lc.readSnapshot(&snap));
+  }
+  CHECK(rt.estimate(&est));
+  CHECK_EQ(est.state, LC709203F_RUNTIME_IDLE);
+  CHECK_EQ(est.seconds, LC709203F_RUNTIME_UNKNOWN);
+  CHECK(est.rate == 0);
+
+  // samples without ITE are ignored, reset() forgets the history
+  lc709203_sample_t s;
+  s.timestamp = 0;
+  s.data.valid = LC709203F_SNAPSHOT_ALL & ~LC709203F_SNAPSHOT_ITE;
+  s.data.ite = 0;
+  rt.addSample(s);
+  CHECK(rt.estimate(&est));
+  CHECK_EQ(est.state, LC709203F_RUNTIME_IDLE);
+  rt.reset();
+  CHECK(!rt.estimate(&est));
+
+  return lc709_test_done();
+}
+
+#else
+
+int main() { return lc709_test_done(); }
+
+#endif
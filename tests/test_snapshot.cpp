@@ -0,0 +1,58 @@
+// readSnapshot() against the emulator: values, per-field validity under
+// injected faults, and delivery to sample sinks
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+class CountingSink : public Adafruit_LC709203F_SampleSink {
+public:
+  void addSample(const lc709203_sample_t &sample) {
+    last = sample;
+    count++;
+  }
+  lc709203_sample_t last;
+  int count = 0;
+};
+
+int main() {
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  emu.setBattery(1000, 423);
+  emu.step(1000, 150);
+
+  lc709203_snapshot_t snap;
+  CHECK(lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid, LC709203F_SNAPSHOT_ALL);
+  CHECK_EQ(snap.voltage, emu.getRegister(LC709203F_CMD_CELLVOLTAGE));
+  CHECK_EQ(snap.ite, emu.getRegister(LC709203F_CMD_CELLITE));
+  CHECK_EQ(snap.rsoc, emu.getRegister(LC709203F_CMD_RSOC));
+  CHECK_EQ(snap.temperature, emu.getRegister(LC709203F_CMD_CELLTEMPERATURE));
+
+  // the first register of the batch is voltage; a failed field reads 0
+  emu.injectNack(1);
+  CHECK(!lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid, LC709203F_SNAPSHOT_ALL & ~LC709203F_SNAPSHOT_VOLTAGE);
+  CHECK_EQ(snap.voltage, 0);
+  CHECK_EQ(snap.ite, emu.getRegister(LC709203F_CMD_CELLITE));
+
+  emu.injectCRCError(2);
+  CHECK(!lc.readSnapshot(&snap));
+  CHECK_EQ(snap.valid,
+           LC709203F_SNAPSHOT_RSOC | LC709203F_SNAPSHOT_TEMPERATURE);
+  CHECK_EQ(snap.ite, 0);
+
+  CountingSink a, b;
+  lc.addSampleSink(&a);
+  lc.addSampleSink(&b);
+  emu.advance(5000);
+  CHECK(lc.readSnapshot(&snap));
+  CHECK_EQ(a.count, 1);
+  CHECK_EQ(b.count, 1);
+  CHECK_EQ(a.last.data.voltage, snap.voltage);
+  CHECK_EQ(a.last.data.valid, LC709203F_SNAPSHOT_ALL);
+  CHECK_EQ(a.last.timestamp, emu.nowMillis());
+
+  return lc709_test_done();
+}
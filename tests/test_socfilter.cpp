@@ -0,0 +1,81 @@
+// State of charge filter behaviour: it starts from the first sample, tracks
+// ITE's coulomb counting, only blends in re-estimate jumps, and leans on
+// the voltage less when the cell is cold
+
+#include "Adafruit_LC709203F_SoCFilter.h"
+#include "lc709203f_test.h"
+
+static lc709203_sample_t sample(uint32_t ms, uint16_t ite, uint16_t mv,
+                                uint16_t temperature = 2982) {
+  lc709203_sample_t s;
+  s.timestamp = ms;
+  s.data.valid = LC709203F_SNAPSHOT_ALL;
+  s.data.ite = ite;
+  s.data.voltage = mv;
+  s.data.temperature = temperature;
+  return s;
+}
+
+int main() {
+  Adafruit_LC709203F_SoCFilter f;
+  CHECK(!f.ready());
+
+  // samples without ITE or voltage are ignored
+  lc709203_sample_t s = sample(0, 500, 3790);
+  s.data.valid = LC709203F_SNAPSHOT_TEMPERATURE;
+  f.addSample(s);
+  CHECK(!f.ready());
+
+  // 3790 mV is 50% on the default curve, so both agree on the first sample
+  f.addSample(sample(0, 500, 3790));
+  CHECK(f.ready());
+  CHECK(f.soc() >= 4990 && f.soc() <= 5010);
+  uint32_t p0 = f.variance();
+
+  // steady readings shrink the uncertainty
+  for (uint32_t t = 1; t <= 100; t++)
+    f.addSample(sample(t * 1000, 500, 3790));
+  CHECK(f.variance() < p0);
+  CHECK(f.soc() >= 4990 && f.soc() <= 5010);
+
+  // a 0.1% ITE step is followed at once, as coulomb counting
+  uint16_t before = f.soc();
+  f.addSample(sample(101000, 499, 3790));
+  CHECK(before - f.soc() >= 8);
+
+  // a 3% jump, as after initRSOC(), is only blended in
+  before = f.soc();
+  f.addSample(sample(102000, 529, 3790));
+  CHECK(f.soc() - before < 100);
+  CHECK(f.soc() > before);
+
+  // the same voltage disagreement pulls less when the cell is cold
+  Adafruit_LC709203F_SoCFilter warm, cold;
+  for (uint32_t t = 0; t < 50; t++) {
+    warm.addSample(sample(t * 1000, 500, 3840));
+    cold.addSample(sample(t * 1000, 500, 3840, 2532)); // -20 C
+  }
+  CHECK(warm.soc() > cold.soc());
+  CHECK(cold.soc() > 5000);
+
+  // a custom curve is used instead of the default
+  static const uint16_t flat_ocv[LC709203F_OCV_POINTS] = {
+      3000, 3100, 3200, 3300, 3400, 3500, 3600, 3700, 3800, 3900, 4000};
+  Adafruit_LC709203F_SoCFilter custom(flat_ocv);
+  custom.setITENoise(10000);
+  custom.addSample(sample(0, 500, 3700));
+  CHECK(custom.soc() > 6500);
+
+  // readings pinned at the limits stay in range
+  Adafruit_LC709203F_SoCFilter edge;
+  edge.addSample(sample(0, 1000, 4300));
+  CHECK(edge.soc() <= 10000);
+  edge.addSample(sample(1000, 0, 2500));
+  CHECK(edge.soc() <= 10000);
+
+  f.reset();
+  CHECK(!f.ready());
+  CHECK(f.variance() > p0);
+
+  return lc709_test_done();
+}
@@ -0,0 +1,134 @@
+// The rolling aggregator against a naive reference that rescans the whole
+// window for every sample, over several windows and value patterns
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Stats.h"
+#include "lc709203f_test.h"
+#include <stdlib.h>
+#include <vector>
+
+typedef uint16_t (*pattern_t)(uint32_t i);
+
+static uint16_t random_full(uint32_t) { return rand() & 0xFFFF; }
+static uint16_t random_narrow(uint32_t) { return 3700 + rand() % 16; }
+static uint16_t rising(uint32_t i) { return i; }
+static uint16_t falling(uint32_t i) { return 0xFFFF - i; }
+static uint16_t constant(uint32_t) { return 0xFFFF; }
+static uint16_t sawtooth(uint32_t i) { return (i * 37) % 101; }
+
+// min, max, mean rounded half up, and the exact population variance
+// rounded down, computed from the last 'n' values of 'v'
+static lc709203_stats_t reference(const std::vector<uint16_t> &v, size_t n) {
+  lc709203_stats_t r;
+  r.min = 0xFFFF;
+  r.max = 0;
+  uint64_t sum = 0;
+  for (size_t i = v.size() - n; i < v.size(); i++) {
+    r.min = v[i] < r.min ? v[i] : r.min;
+    r.max = v[i] > r.max ? v[i] : r.max;
+    sum += v[i];
+  }
+  r.mean = (sum * 2 + n) / (2 * n);
+  // n^3 * variance = sum over i of (n * v[i] - sum)^2, exact in 128 bits
+  unsigned __int128 acc = 0;
+  for (size_t i = v.size() - n; i < v.size(); i++) {
+    int64_t d = (int64_t)v[i] * n - (int64_t)sum;
+    acc += (unsigned __int128)((__int128)d * d);
+  }
+  r.variance = (uint32_t)(acc / ((unsigned __int128)n * n * n));
+  return r;
+}
+
+// compares with the reference every 'every' samples and after the last
+static void check_window(uint16_t window, pattern_t pattern, uint32_t n,
+                         uint32_t every = 1) {
+  std::vector<lc709203_stats_slot_t> slots(window);
+  Adafruit_LC709203F_Stats stats(slots.data(), window);
+  std::vector<uint16_t> values[LC709203F_STATS_CHANNELS];
+
+  for (uint32_t i = 0; i < n; i++) {
+    lc709203_snapshot_t snap;
+    snap.valid = LC709203F_SNAPSHOT_ALL;
+    snap.voltage = pattern(i);
+    snap.ite = pattern(i + 1);
+    snap.temperature = pattern(i + 2);
+    CHECK(stats.add(snap));
+    values[LC709203F_STATS_VOLTAGE].push_back(snap.voltage);
+    values[LC709203F_STATS_ITE].push_back(snap.ite);
+    values[LC709203F_STATS_TEMPERATURE].push_back(snap.temperature);
+
+    size_t in = i + 1 < window ? i + 1 : window;
+    CHECK_EQ(stats.count(), in);
+    if (i % every && i != n - 1)
+      continue;
+    for (uint8_t ch = 0; ch < LC709203F_STATS_CHANNELS; ch++) {
+      lc709203_stats_t got, want = reference(values[ch], in);
+      CHECK(stats.get((lc709203_stats_channel_t)ch, &got));
+      if (got.min != want.min || got.max != want.max ||
+          got.mean != want.mean || got.variance != want.variance) {
+        CHECK_EQ(window, 0);
+        fprintf(stderr, "  sample %u channel %u: got %u/%u/%u/%u want "
+                        "%u/%u/%u/%u\n",
+                (unsigned)i, ch, got.min, got.max, got.mean,
+                (unsigned)got.variance, want.min, want.max, want.mean,
+                (unsigned)want.variance);
+        return;
+      }
+    }
+  }
+}
+
+int main() {
+  static const uint16_t windows[] = {1, 2, 3, 7, 60, 1000};
+  static const pattern_t patterns[] = {random_full, random_narrow, rising,
+                                       falling,     constant,      sawtooth};
+  srand(1);
+  for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++)
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+      check_window(windows[w], patterns[p], 3 * windows[w] + 50);
+
+  // the largest window of full scale values, where the sums are widest
+  check_window(65535, random_full, 65535 + 1000, 4999);
+  check_window(65535, constant, 65535 + 10, 4999);
+
+  // incomplete snapshots are skipped, an empty window has no aggregates
+  lc709203_stats_slot_t slots[4];
+  Adafruit_LC709203F_Stats stats(slots, 4);
+  lc709203_stats_t s;
+  CHECK(!stats.get(LC709203F_STATS_VOLTAGE, &s));
+  lc709203_snapshot_t snap;
+  snap.valid = LC709203F_SNAPSHOT_ALL & ~LC709203F_SNAPSHOT_TEMPERATURE;
+  snap.voltage = snap.ite = snap.temperature = 1;
+  CHECK(!stats.add(snap));
+  CHECK_EQ(stats.skipped, 1);
+  CHECK_EQ(stats.count(), 0);
+  CHECK(!stats.get(LC709203F_STATS_CHANNELS, &s));
+
+  // as a sink, fed from the driver's readSnapshot()
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  CHECK(lc.setTemperatureMode(LC709203F_TEMPERATURE_THERMISTOR));
+  lc.addSampleSink(&stats);
+  std::vector<uint16_t> mv;
+  for (int i = 0; i < 10; i++) {
+    emu.step(1000, 500);
+    lc709203_snapshot_t read;
+    CHECK(lc.readSnapshot(&read));
+    mv.push_back(read.voltage);
+  }
+  CHECK_EQ(stats.count(), 4);
+  lc709203_stats_t want = reference(mv, 4);
+  CHECK(stats.get(LC709203F_STATS_VOLTAGE, &s));
+  CHECK_EQ(s.min, want.min);
+  CHECK_EQ(s.max, want.max);
+  CHECK_EQ(s.mean, want.mean);
+  CHECK_EQ(s.variance, want.variance);
+
+  stats.reset();
+  CHECK_EQ(stats.count(), 0);
+  CHECK(!stats.get(LC709203F_STATS_VOLTAGE, &s));
+
+  return lc709_test_done();
+}
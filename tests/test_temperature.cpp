@@ -0,0 +1,49 @@
+// The integer temperature conversion over the whole register range,
+// against the original map() based getter and the 0.1 K definition
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "lc709203f_test.h"
+
+// Arduino's map(), as the original getCellTemperature() used it
+static long arduino_map(long x, long in_min, long in_max, long out_min,
+                        long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+int main() {
+  for (uint16_t reg = LC709203F_TEMP_MIN; reg <= LC709203F_TEMP_MAX; reg++) {
+    int16_t dc = lc709_temp_to_deci_celsius(reg);
+    // 0.1 K, with 0 *C defined by the chip as 273.2 K
+    CHECK_EQ(dc, (long)reg - 2732);
+    CHECK_EQ(dc, arduino_map(reg, 0x9E4, 0xD04, -200, 600));
+    CHECK_EQ(lc709_deci_celsius_to_temp(dc), reg);
+  }
+  CHECK_EQ(lc709_temp_to_deci_celsius(LC709203F_TEMP_MIN), -200);
+  CHECK_EQ(lc709_temp_to_deci_celsius(LC709203F_TEMP_ZERO_C), 0);
+  CHECK_EQ(lc709_temp_to_deci_celsius(LC709203F_TEMP_MAX), 600);
+
+  // through the chip: every settable temperature reads back the same, in
+  // the integer and (if built) float getters
+  Adafruit_LC709203F_Emulator emu;
+  Adafruit_LC709203F lc;
+  CHECK(lc.begin(&emu));
+  CHECK(lc.setTemperatureMode(LC709203F_TEMPERATURE_I2C));
+  for (int16_t dc = -200; dc <= 600; dc++) {
+    CHECK(lc.setCellTemperature(dc));
+    CHECK_EQ(emu.getRegister(LC709203F_CMD_CELLTEMPERATURE),
+             lc709_deci_celsius_to_temp(dc));
+    int16_t back = 0;
+    CHECK(lc.readCellTemperatureC(&back));
+    CHECK_EQ(back, dc);
+#ifndef LC709203F_NO_FLOAT
+    CHECK(lc.getCellTemperature() == (float)(dc / 10.0));
+#endif
+  }
+  CHECK(!lc.setCellTemperature(-201));
+  CHECK(!lc.setCellTemperature(601));
+  CHECK_EQ(emu.getRegister(LC709203F_CMD_CELLTEMPERATURE),
+           lc709_deci_celsius_to_temp(600));
+
+  return lc709_test_done();
+}
@@ -0,0 +1,104 @@
+// Per-bus worker threads: every gauge gets read, samples are published
+// whole while readers poll them from another thread, and start()/stop()
+// behave. Build with CXXFLAGS="-std=gnu++11 -O1 -g -fsanitize=thread" to
+// also race-check it
+
+#include "Adafruit_LC709203F.h"
+#include "Adafruit_LC709203F_Emulator.h"
+#include "Adafruit_LC709203F_Workers.h"
+#include "lc709203f_test.h"
+#include <chrono>
+#include <thread>
+
+#define BUSES 3
+#define GAUGES (2 * BUSES)
+
+// after each snapshot, set all four registers to the next count, so a
+// sample mixing two snapshots shows up as unequal fields
+class Counter : public Adafruit_LC709203F_SampleSink {
+public:
+  Adafruit_LC709203F_Emulator *emu;
+  uint16_t n = 1;
+  void addSample(const lc709203_sample_t &) {
+    n++;
+    emu->setRegister(LC709203F_CMD_CELLVOLTAGE, n);
+    emu->setRegister(LC709203F_CMD_CELLITE, n);
+    emu->setRegister(LC709203F_CMD_RSOC, n);
+    emu->setRegister(LC709203F_CMD_CELLTEMPERATURE, n);
+  }
+};
+
+int main() {
+  static Adafruit_LC709203F_Emulator emu[GAUGES];
+  static Adafruit_LC709203F gauge[GAUGES];
+  static Counter counter[GAUGES];
+  static lc709203_worker_slot_t slots[GAUGES];
+  Adafruit_LC709203F_Workers workers(slots, GAUGES);
+
+  lc709203_sample_t s;
+  for (int i = 0; i < GAUGES; i++) {
+    CHECK(gauge[i].begin(&emu[i]));
+    counter[i].emu = &emu[i];
+    counter[i].addSample(s);
+    gauge[i].addSampleSink(&counter[i]);
+    CHECK_EQ(workers.add(&gauge[i], i % BUSES), i);
+    CHECK(!workers.read(i, &s)); // nothing published yet
+  }
+  CHECK(!workers.read(GAUGES, &s));
+
+  CHECK(workers.start());
+  CHECK(!workers.start());
+  CHECK_EQ(workers.add(&gauge[0], 0), -1);
+
+  // read every slot over and over while the workers publish
+  uint32_t last[GAUGES] = {0}, torn = 0, backwards = 0, reads = 0;
+  std::chrono::steady_clock::time_point end =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < GAUGES; i++) {
+      uint32_t gen;
+      if (!workers.read(i, &s, &gen))
+        continue;
+      reads++;
+      if (s.data.valid != LC709203F_SNAPSHOT_ALL ||
+          s.data.voltage != s.data.ite || s.data.ite != s.data.rsoc ||
+          s.data.rsoc != s.data.temperature)
+        torn++;
+      if (gen < last[i])
+        backwards++;
+      last[i] = gen;
+    }
+    std::this_thread::yield();
+  }
+  workers.stop();
+
+  CHECK(reads > 0);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(backwards, 0);
+  // each gauge was read by its worker, and the count matches its sink's
+  for (int i = 0; i < GAUGES; i++) {
+    uint32_t gen;
+    CHECK(workers.read(i, &s, &gen));
+    CHECK(gen > 0);
+    CHECK_EQ((uint16_t)(gen + 1), (uint16_t)(counter[i].n - 1));
+    CHECK_EQ(s.data.voltage, (uint16_t)(counter[i].n - 1));
+  }
+  uint32_t scans = workers.scans();
+  CHECK(scans > 0);
+
+  // a period spaces the scans out: about 10 in 200 ms at 20 ms
+  Adafruit_LC709203F_Workers paced(slots, GAUGES);
+  for (int i = 0; i < GAUGES; i++)
+    paced.add(&gauge[i], i % BUSES);
+  CHECK(paced.start(20));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  paced.stop();
+  CHECK(paced.scans() >= BUSES * 5);
+  CHECK(paced.scans() <= BUSES * 12);
+
+  // stopped workers can be started again
+  CHECK(paced.start());
+  paced.stop();
+
+  return lc709_test_done();
+}